@@ -0,0 +1,128 @@
+#ifndef FLT1_CONSTRAINTGENERATION_H
+#define FLT1_CONSTRAINTGENERATION_H
+
+// Everything TerminationChecker needs: rules, interpretations, constraint generation, the solver process and model
+// verification. Nothing in here prints, so the command line tool and its workers stay in SMTGeneration.h.
+
+#include <map>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <cctype>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <array>
+#include <limits>
+#include <cstdlib>
+#include <cmath>
+#include <cerrno>
+#include <mutex>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#endif
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "InequalitiesGeneration.h"
+#include "Verdict.h"
+#include "SExpressionParser.h"
+#include "InterpretationTemplate.h"
+#include "SolverProcess.h"
+
+std::pair<std::string, std::string> parseInput(const std::string& input) {
+    size_t arrow_pos = input.find("->");
+    std::string lhs = input.substr(0, arrow_pos);
+    std::string rhs = input.substr(arrow_pos + 2);
+
+    lhs = lhs.substr(lhs.find_first_not_of(' '));
+    lhs = lhs.substr(0, lhs.find_last_not_of(' ') + 1);
+
+    rhs = rhs.substr(rhs.find_first_not_of(' '));
+    rhs = rhs.substr(0, rhs.find_last_not_of(' ') + 1);
+
+    return { lhs, rhs };
+}
+
+#include "RuleCanonicalization.h"
+#include "ModelVerification.h"
+#include "MatrixInterpretation.h"
+
+const long long matrixSearchLimit = 10000000;
+
+// In rule removal mode every rule only has to decrease weakly, and the Bool strict<indicator> tells whether it also
+// decreases strictly; at least one of them has to.
+void assertRemovableRule(std::ostream& assertions, int indicator, const std::string& weak, const std::string& strict) {
+    assertions << "(declare-fun strict" << indicator << " () Bool)" << '\n';
+    assertions << "(assert " << weak << ")" << '\n';
+    assertions << "(assert (=> strict" << indicator << " " << strict << "))" << '\n';
+}
+
+// Declarations of letters and words go to declarations and stay valid for later rule systems over the same letters,
+// the constraints of the rules themselves go to assertions.
+bool generateRequirements(std::ostream& declarations, std::ostream& assertions, std::vector<char>& symbols, std::unordered_set<std::string>& constraints, const std::vector<std::string>& coefficientNames, const std::pair<std::string, std::string>& sides, const std::map<std::pair<int, bool>, std::string>& lhs, const std::map<std::pair<int, bool>, std::string>& rhs, int indicator = -1) {
+    for (const std::string* side : { &sides.first, &sides.second }) {
+        for (auto symbol : *side) {
+            if (std::find(symbols.begin(), symbols.end(), symbol) == symbols.end()) {
+                for (const auto& name : coefficientNames) {
+                    declarations << "(declare-fun " << name << "_" << symbol << " () Int)" << '\n';
+                }
+                for (const auto& name : coefficientNames) {
+                    declarations << "(assert (> " << name << "_" << symbol << " 0))" << '\n';
+                }
+                symbols.emplace_back(symbol);
+            }
+        }
+    }
+
+    /*std::vector<std::string> inequalities = generateInequalities(lhs, rhs);
+
+    for (const auto& inequality : inequalities) {
+        smtFile << "(assert " << inequality << ")" << std::endl;
+    }*/
+
+    if (indicator >= 0) {
+        assertRemovableRule(assertions, indicator, generateInequalities(lhs, rhs, false), generateInequalities(lhs, rhs));
+        return true;
+    }
+
+    std::string inequality = generateInequalities(lhs, rhs);
+    if (!constraints.insert(inequality).second) {
+        return false;
+    }
+    assertions << "(assert " << inequality << ")" << '\n';
+    return true;
+}
+
+bool generateMatrixRequirements(std::ostream& declarations, std::ostream& assertions, std::vector<char>& symbols, std::unordered_set<std::string>& constraints, MatrixEngine& matrices, const std::pair<std::string, std::string>& sides, int indicator = -1) {
+    for (const std::string* side : { &sides.first, &sides.second }) {
+        for (auto symbol : *side) {
+            if (std::find(symbols.begin(), symbols.end(), symbol) == symbols.end()) {
+                matrices.declareSymbol(declarations, symbol);
+                symbols.emplace_back(symbol);
+            }
+        }
+    }
+
+    const std::vector<std::string>& lhs = matrices.word(declarations, sides.first);
+    const std::vector<std::string>& rhs = matrices.word(declarations, sides.second);
+    if (indicator >= 0) {
+        assertRemovableRule(assertions, indicator, matrices.inequality(lhs, rhs, false), matrices.inequality(lhs, rhs));
+        return true;
+    }
+
+    std::string inequality = matrices.inequality(lhs, rhs);
+    if (!constraints.insert(inequality).second) {
+        return false;
+    }
+    assertions << "(assert " << inequality << ")" << '\n';
+    return true;
+}
+
+#endif //FLT1_CONSTRAINTGENERATION_H
@@ -1,79 +1,6 @@
 #ifndef FLT1_INEQUALITIESGENERATION_H
 #define FLT1_INEQUALITIESGENERATION_H
 
-std::map<std::pair<int, bool>, std::string> extractCoefficients(Node* node, int degree_w = 0, bool is_x = false, bool is_w = false) {
-    std::map<std::pair<int, bool>, std::string> coefficients;
-
-    if (node == nullptr) {
-        return coefficients;
-    }
-
-    auto* ordinalNode = dynamic_cast<OrdinalNode*>(node);
-    if (ordinalNode != nullptr) {
-        if (ordinalNode->ordinal.value == "w") {
-            if (is_w) {
-
-                coefficients[{degree_w, is_x}] = ordinalNode->ordinal.coefficient;
-            } else {
-                coefficients[{ordinalNode->ordinal.degree, is_x}] = ordinalNode->ordinal.coefficient;
-            }
-        } else if (ordinalNode->ordinal.value != "x") {
-            coefficients[{degree_w, is_x}] = ordinalNode->ordinal.value;
-        }
-    }
-
-    is_w = false;
-    auto* operationNode = dynamic_cast<OperationNode*>(node);
-    if (operationNode != nullptr) {
-        if (operationNode->operation == "*") {
-            auto *leftOrdinalNode = dynamic_cast<OrdinalNode *>(operationNode->left);
-            if (leftOrdinalNode != nullptr && leftOrdinalNode->ordinal.value == "w") {
-                degree_w += leftOrdinalNode->ordinal.degree;
-                is_w = true;
-            }
-            auto *rightOrdinalNode = dynamic_cast<OrdinalNode *>(operationNode->right);
-            if (rightOrdinalNode != nullptr && rightOrdinalNode->ordinal.value == "x") {
-                is_x = true;
-            }
-        }
-
-        auto leftCoefficients = extractCoefficients(operationNode->left, degree_w, is_x, is_w);
-        auto rightCoefficients = extractCoefficients(operationNode->right, degree_w, is_x, is_w);
-
-        for (const auto& leftPair : leftCoefficients) {
-            std::pair<int, int> degrees = leftPair.first;
-            std::string leftCoefficient = leftPair.second;
-
-            if (coefficients.count(degrees) > 0) {
-                std::string& mergedCoefficient = coefficients[degrees];
-
-                mergedCoefficient += "+" + leftCoefficient;
-
-                coefficients[degrees] = mergedCoefficient;
-            } else {
-                coefficients[degrees] = leftCoefficient;
-            }
-        }
-
-        for (const auto& rightPair : rightCoefficients) {
-            std::pair<int, int> degrees = rightPair.first;
-            std::string rightCoefficient = rightPair.second;
-
-            if (coefficients.count(degrees) > 0) {
-                std::string& mergedCoefficient = coefficients[degrees];
-
-                mergedCoefficient += "+" + rightCoefficient;
-
-                coefficients[degrees] = mergedCoefficient;
-            } else {
-                coefficients[degrees] = rightCoefficient;
-            }
-        }
-    }
-
-    return coefficients;
-}
-
 std::vector<std::string> splitByAddition(const std::string& expression) {
     std::vector<std::string> terms;
     std::string term;
@@ -110,7 +37,9 @@ std::vector<std::string> splitByMultiplication(const std::string& expression) {
     return terms;
 }
 
-std::string generateLogicalExpression(const std::vector<std::pair<int, std::string>>& lhs, const std::vector<std::pair<int, std::string>>& rhs, const std::string& comparator = "") {
+// Compares the coefficients lexicographically from the highest power of w down. innermost, when given, replaces
+// comparator in the comparison of the last coefficient, so (">", ">=") gives a lexicographic >=.
+std::string generateLogicalExpression(const std::vector<std::pair<int, std::string>>& lhs, const std::vector<std::pair<int, std::string>>& rhs, const std::string& comparator = "", const std::string& innermost = "") {
     std::string expression;
     int helper = 0;
 
@@ -200,7 +129,7 @@ std::string generateLogicalExpression(const std::vector<std::pair<int, std::stri
                     expression += "(or (" + comparator + " " + lhsNewCoefficient + " " + rhsNewCoefficient + ") (and (= " + lhsNewCoefficient + " " + rhsNewCoefficient + ")";
                     helper += 2;
                 } else {
-                    expression += "(" + comparator + " " + lhsNewCoefficient + " " + rhsNewCoefficient + ")";
+                    expression += "(" + (innermost.empty() ? comparator : innermost) + " " + lhsNewCoefficient + " " + rhsNewCoefficient + ")";
                 }
 
                 ++lhsIt;
@@ -486,7 +415,9 @@ std::string generateLogicalExpression(const std::vector<std::pair<int, std::stri
     return expression;
 }
 
-std::string generateInequalities(const std::map<std::pair<int, bool>, std::string>& lhs, const std::map<std::pair<int, bool>, std::string>& rhs) {
+// With strict set to false only a weak decrease is required: the finite part may also stay the same, so only its
+// last comparison is relaxed to >=.
+std::string generateInequalities(const std::map<std::pair<int, bool>, std::string>& lhs, const std::map<std::pair<int, bool>, std::string>& rhs, bool strict = true) {
     std::vector<std::pair<int, std::string>> lhsWithX, lhsWithoutX, rhsWithX, rhsWithoutX;
 
     for (const auto& pair : lhs) {
@@ -510,8 +441,8 @@ std::string generateInequalities(const std::map<std::pair<int, bool>, std::strin
     std::sort(lhsWithoutX.rbegin(), lhsWithoutX.rend());
     std::sort(rhsWithoutX.rbegin(), rhsWithoutX.rend());
 
-    std::string expression = "(or (and " + generateLogicalExpression(lhsWithX, rhsWithX, ">") + generateLogicalExpression(lhsWithoutX, rhsWithoutX, ">=") + ") " +
-                             "(and " + generateLogicalExpression(lhsWithX, rhsWithX) + generateLogicalExpression(lhsWithoutX, rhsWithoutX, ">") + "))";
+    std::string expression = "(or (and " + generateLogicalExpression(lhsWithX, rhsWithX, ">") + generateLogicalExpression(lhsWithoutX, rhsWithoutX, ">", ">=") + ") " +
+                             "(and " + generateLogicalExpression(lhsWithX, rhsWithX) + generateLogicalExpression(lhsWithoutX, rhsWithoutX, ">", strict ? "" : ">=") + "))";
 
     return expression;
 }
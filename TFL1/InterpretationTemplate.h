@@ -0,0 +1,241 @@
+#ifndef FLT1_INTERPRETATIONTEMPLATE_H
+#define FLT1_INTERPRETATIONTEMPLATE_H
+
+// A letter is interpreted as x -> factor * x + constant, where factor and constant are ordinals below w^(degree+1)
+// in Cantor normal form: element i of each vector is the coefficient of w^i.
+template <typename T>
+class OrdinalLetter {
+public:
+    std::vector<T> factor;
+    std::vector<T> constant;
+
+    explicit OrdinalLetter(int degree) : factor(degree + 1), constant(degree + 1) {}
+};
+
+// Unlike a letter, a word has no fixed degree: composing n letters of degree d gives degree up to n*d, so the
+// coefficients are kept in vectors that are reused from one word to the next.
+template <typename T>
+class OrdinalWord {
+public:
+    std::vector<T> factor;
+    std::vector<T> constant;
+};
+
+const long long saturatedCoefficient = std::numeric_limits<long long>::max();
+
+bool isZeroCoefficient(const std::string& coefficient) {
+    return coefficient.empty();
+}
+
+bool isZeroCoefficient(long long coefficient) {
+    return coefficient == 0;
+}
+
+std::string addCoefficients(const std::string& left, const std::string& right) {
+    if (left.empty()) {
+        return right;
+    }
+    if (right.empty()) {
+        return left;
+    }
+    return left + "+" + right;
+}
+
+long long addCoefficients(long long left, long long right) {
+    if (left > saturatedCoefficient - right) {
+        return saturatedCoefficient;
+    }
+    return left + right;
+}
+
+std::string multiplyCoefficients(const std::string& left, const std::string& right) {
+    if (left.empty() || right.empty()) {
+        return "";
+    }
+    std::string product;
+    for (const auto& leftTerm : splitByAddition(left)) {
+        for (const auto& rightTerm : splitByAddition(right)) {
+            if (!product.empty()) {
+                product += "+";
+            }
+            product += leftTerm + "*" + rightTerm;
+        }
+    }
+    return product;
+}
+
+long long multiplyCoefficients(long long left, long long right) {
+    if (left != 0 && right > saturatedCoefficient / left) {
+        return saturatedCoefficient;
+    }
+    return left * right;
+}
+
+template <typename T>
+int leadingDegree(const std::vector<T>& coefficients) {
+    for (int i = static_cast<int>(coefficients.size()) - 1; i >= 0; i--) {
+        if (!isZeroCoefficient(coefficients[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// right := left * right. For left with leading degree p, left * w^j = w^(p+j) when j > 0, and left * n only
+// scales the leading coefficient of left, so the result is right shifted up by p with left's tail underneath.
+template <typename T>
+void multiplyOrdinals(const std::vector<T>& left, std::vector<T>& right) {
+    int p = leadingDegree(left);
+    int q = leadingDegree(right);
+    if (p < 0 || q < 0) {
+        right.clear();
+        return;
+    }
+
+    T finite = right[0];
+    right.resize(q + p + 1);
+    for (int i = q + p; i > p; i--) {
+        right[i] = std::move(right[i - p]);
+    }
+    if (isZeroCoefficient(finite)) {
+        for (int i = 0; i <= p; i++) {
+            right[i] = T();
+        }
+    } else {
+        right[p] = multiplyCoefficients(left[p], finite);
+        for (int i = 0; i < p; i++) {
+            right[i] = left[i];
+        }
+    }
+}
+
+// left := left + right. Terms of left below the leading degree of right are absorbed.
+template <typename T>
+void addOrdinals(std::vector<T>& left, const std::vector<T>& right) {
+    int q = leadingDegree(right);
+    if (q < 0) {
+        return;
+    }
+    if (static_cast<int>(left.size()) < q + 1) {
+        left.resize(q + 1);
+    }
+    left[q] = addCoefficients(left[q], right[q]);
+    for (int i = 0; i < q; i++) {
+        left[i] = right[i];
+    }
+}
+
+template <typename T>
+int compareOrdinals(const std::vector<T>& left, const std::vector<T>& right) {
+    int p = leadingDegree(left);
+    int q = leadingDegree(right);
+    if (p != q) {
+        return p > q ? 1 : -1;
+    }
+    for (int i = p; i >= 0; i--) {
+        if (left[i] != right[i]) {
+            return left[i] > right[i] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+// word := letter o word
+template <typename T>
+void composeLetter(const OrdinalLetter<T>& letter, OrdinalWord<T>& word) {
+    multiplyOrdinals(letter.factor, word.factor);
+    multiplyOrdinals(letter.factor, word.constant);
+    addOrdinals(word.constant, letter.constant);
+}
+
+template <typename T>
+void composeWord(const std::string& word, const std::map<char, OrdinalLetter<T>>& letters, OrdinalWord<T>& result) {
+    const OrdinalLetter<T>& last = letters.at(word.back());
+    size_t size = word.size() * (last.factor.size() - 1) + 1;
+    result.factor.reserve(size);
+    result.constant.reserve(size);
+    result.factor.assign(last.factor.begin(), last.factor.end());
+    result.constant.assign(last.constant.begin(), last.constant.end());
+
+    for (auto symbol = word.crbegin() + 1; symbol != word.crend(); ++symbol) {
+        composeLetter(letters.at(*symbol), result);
+    }
+}
+
+std::string templateCoefficientName(int index) {
+    if (index < 26) {
+        return std::string(1, static_cast<char>('a' + index));
+    }
+    return "k" + std::to_string(index);
+}
+
+// Coefficients are named from the highest power of w down, first for the factor of x, then for the constant:
+// degree 1 gives (w*a + b) * x + w*c + d, degree 2 gives (w^2*a + w*b + c) * x + w^2*d + w*e + f.
+std::vector<std::string> templateCoefficientNames(int degree) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 2 * (degree + 1); i++) {
+        names.push_back(templateCoefficientName(i));
+    }
+    return names;
+}
+
+template <typename T, typename Coefficient>
+OrdinalLetter<T> makeLetter(int degree, char symbol, Coefficient coefficient) {
+    OrdinalLetter<T> letter(degree);
+    for (int i = 0; i <= degree; i++) {
+        letter.factor[degree - i] = coefficient(symbol, templateCoefficientName(i));
+        letter.constant[degree - i] = coefficient(symbol, templateCoefficientName(degree + 1 + i));
+    }
+    return letter;
+}
+
+std::map<std::pair<int, bool>, std::string> templateCoefficients(const std::string& word, int degree) {
+    std::map<char, OrdinalLetter<std::string>> letters;
+    for (char symbol : word) {
+        if (letters.count(symbol) == 0) {
+            letters.emplace(symbol, makeLetter<std::string>(degree, symbol, [](char s, const std::string& name) {
+                return name + "_" + s;
+            }));
+        }
+    }
+
+    OrdinalWord<std::string> composed;
+    composeWord(word, letters, composed);
+
+    std::map<std::pair<int, bool>, std::string> coefficients;
+    for (int i = 0; i < static_cast<int>(composed.factor.size()); i++) {
+        if (!composed.factor[i].empty()) {
+            coefficients[{i, true}] = composed.factor[i];
+        }
+    }
+    for (int i = 0; i < static_cast<int>(composed.constant.size()); i++) {
+        if (!composed.constant[i].empty()) {
+            coefficients[{i, false}] = composed.constant[i];
+        }
+    }
+    return coefficients;
+}
+
+void printCoefficients(std::ostream& os, const std::map<std::pair<int, bool>, std::string>& coefficients) {
+    for (bool is_x : { true, false }) {
+        bool first = true;
+        os << (is_x ? "(" : ") * x + ");
+        for (auto it = coefficients.rbegin(); it != coefficients.rend(); ++it) {
+            if (it->first.second != is_x) {
+                continue;
+            }
+            if (!first) {
+                os << " + ";
+            }
+            first = false;
+            if (it->first.first > 1) {
+                os << "w^" << it->first.first << " * ";
+            } else if (it->first.first == 1) {
+                os << "w * ";
+            }
+            os << "(" << it->second << ")";
+        }
+    }
+}
+
+#endif //FLT1_INTERPRETATIONTEMPLATE_H
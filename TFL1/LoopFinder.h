@@ -0,0 +1,195 @@
+#ifndef FLT1_LOOPFINDER_H
+#define FLT1_LOOPFINDER_H
+
+// Aho-Corasick automaton over the left-hand sides of all rules, so that one pass over a word finds every redex.
+// The goto function is completed into a full transition table over the letters that occur in left-hand sides.
+class RuleAutomaton {
+public:
+    explicit RuleAutomaton(const RuleSystem& system) {
+        letters.fill(-1);
+        for (const auto& rule : system.rules) {
+            for (char symbol : rule.first) {
+                int& letter = letters[static_cast<unsigned char>(symbol)];
+                if (letter < 0) {
+                    letter = alphabet++;
+                }
+            }
+        }
+
+        addState();
+        for (size_t i = 0; i < system.rules.size(); i++) {
+            int state = 0;
+            for (char symbol : system.rules[i].first) {
+                int& target = transitions[state * alphabet + letters[static_cast<unsigned char>(symbol)]];
+                if (target < 0) {
+                    int created = addState();
+                    transitions[state * alphabet + letters[static_cast<unsigned char>(symbol)]] = created;
+                    state = created;
+                } else {
+                    state = target;
+                }
+            }
+            outputs[state].push_back(i);
+            lengths.push_back(system.rules[i].first.size());
+        }
+
+        std::vector<int> queue;
+        for (int letter = 0; letter < alphabet; letter++) {
+            int& target = transitions[letter];
+            if (target < 0) {
+                target = 0;
+            } else {
+                queue.push_back(target);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); head++) {
+            int state = queue[head];
+            for (int letter = 0; letter < alphabet; letter++) {
+                int& target = transitions[state * alphabet + letter];
+                int fallback = transitions[failures[state] * alphabet + letter];
+                if (target < 0) {
+                    target = fallback;
+                } else {
+                    failures[target] = fallback;
+                    outputs[target].insert(outputs[target].end(), outputs[fallback].begin(), outputs[fallback].end());
+                    queue.push_back(target);
+                }
+            }
+        }
+    }
+
+    // Calls match(position, rule) for every occurrence of a left-hand side in word.
+    template <typename Match>
+    void match(const std::string& word, Match match) const {
+        int state = 0;
+        for (size_t i = 0; i < word.size(); i++) {
+            int letter = letters[static_cast<unsigned char>(word[i])];
+            state = letter < 0 ? 0 : transitions[state * alphabet + letter];
+            for (size_t rule : outputs[state]) {
+                match(i + 1 - lengths[rule], rule);
+            }
+        }
+    }
+
+private:
+    std::array<int, 256> letters;
+    int alphabet = 0;
+    std::vector<int> transitions;
+    std::vector<int> failures;
+    std::vector<std::vector<size_t>> outputs;
+    std::vector<size_t> lengths;
+
+    int addState() {
+        transitions.resize(transitions.size() + alphabet, -1);
+        failures.push_back(0);
+        outputs.emplace_back();
+        return static_cast<int>(failures.size()) - 1;
+    }
+};
+
+// words[0] rewrites to words[i + 1] by rules[i] at positions[i], and the last word contains words[0].
+class LoopWitness {
+public:
+    std::vector<std::string> words;
+    std::vector<size_t> rules;
+    std::vector<size_t> positions;
+};
+
+const size_t loopSearchStates = 200000;
+
+// Breadth-first search over the derivations of the left-hand side of rule origin. Words longer than limit are not
+// expanded, and every word is visited once. searched counts the words of all searches together, none of which goes on
+// once it reaches budget.
+bool searchLoop(const RuleSystem& system, const RuleAutomaton& automaton, size_t origin, size_t limit, const std::atomic<bool>& stop,
+                std::atomic<size_t>& searched, size_t budget, LoopWitness& witness) {
+    struct Step {
+        std::string word;
+        int parent;
+        size_t rule;
+        size_t position;
+    };
+
+    const std::string& start = system.rules[origin].first;
+    std::vector<Step> steps = { { start, -1, 0, 0 } };
+    std::unordered_set<std::string> visited = { start };
+    int looping = -1;
+
+    for (size_t head = 0; head < steps.size() && looping < 0 && steps.size() < loopSearchStates && searched < budget && !stop; head++) {
+        std::string word = steps[head].word;
+        automaton.match(word, [&](size_t position, size_t rule) {
+            if (looping >= 0) {
+                return;
+            }
+            const auto& sides = system.rules[rule];
+            std::string next = word.substr(0, position) + sides.second + word.substr(position + sides.first.size());
+            bool loops = next.find(start) != std::string::npos;
+            if (next.size() > limit || (!loops && !visited.insert(next).second)) {
+                return;
+            }
+            steps.push_back({ next, static_cast<int>(head), rule, position });
+            searched++;
+            if (loops) {
+                looping = static_cast<int>(steps.size()) - 1;
+            }
+        });
+    }
+    if (looping < 0) {
+        return false;
+    }
+
+    witness = LoopWitness();
+    for (int step = looping; step >= 0; step = steps[step].parent) {
+        witness.words.push_back(steps[step].word);
+        if (steps[step].parent >= 0) {
+            witness.rules.push_back(steps[step].rule);
+            witness.positions.push_back(steps[step].position);
+        }
+    }
+    std::reverse(witness.words.begin(), witness.words.end());
+    std::reverse(witness.rules.begin(), witness.rules.end());
+    std::reverse(witness.positions.begin(), witness.positions.end());
+    return true;
+}
+
+// Searches from the left-hand sides of all rules on one thread per core until a loop is found, which sets stop, until
+// stop is set from outside or until budget words have been searched in total.
+bool findLoop(const RuleSystem& system, std::atomic<bool>& stop, size_t budget, LoopWitness& witness) {
+    RuleAutomaton automaton(system);
+    size_t longest = 0;
+    for (const auto& rule : system.rules) {
+        longest = std::max({ longest, rule.first.size(), rule.second.size() });
+    }
+    size_t limit = std::max<size_t>(16, 4 * longest);
+
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> searched(0);
+    std::mutex mutex;
+    bool found = false;
+    auto work = [&]() {
+        size_t i;
+        while (!stop && searched < budget && (i = next++) < system.rules.size()) {
+            LoopWitness candidate;
+            if (searchLoop(system, automaton, i, limit, stop, searched, budget, candidate)) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!found) {
+                    witness = std::move(candidate);
+                    found = true;
+                }
+                stop = true;
+            }
+        }
+    };
+    runOnCores(system.rules.size(), work);
+    return found;
+}
+
+void printLoop(const RuleSystem& system, const LoopWitness& witness) {
+    std::cout << "The system does not terminate, " << witness.words.front() << " rewrites to a word containing itself:" << std::endl;
+    std::cout << "  " << witness.words.front() << std::endl;
+    for (size_t i = 0; i < witness.rules.size(); i++) {
+        const auto& rule = system.rules[witness.rules[i]];
+        std::cout << "  -> " << witness.words[i + 1] << "   (" << rule.first << " -> " << rule.second << " at " << witness.positions[i] << ")" << std::endl;
+    }
+}
+
+#endif //FLT1_LOOPFINDER_H
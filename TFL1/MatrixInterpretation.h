@@ -0,0 +1,345 @@
+#ifndef FLT1_MATRIXINTERPRETATION_H
+#define FLT1_MATRIXINTERPRETATION_H
+
+// A letter s is interpreted as x -> M_s * x + v_s over N^d. Words are composed as products of the augmented
+// (d+1)x(d+1) matrices [[M_s, v_s], [0, 1]], whose last row is constant and therefore never stored symbolically.
+// A rule l -> r decreases strictly when [l] >= [r] entrywise and the first component of v_l exceeds that of v_r,
+// and weakly when [l] >= [r] entrywise.
+std::string matrixCoefficientName(int row, int column, int dimension) {
+    if (column == dimension) {
+        return "v" + std::to_string(row);
+    }
+    return "m" + std::to_string(row) + "_" + std::to_string(column);
+}
+
+std::vector<std::string> matrixCoefficientNames(int dimension) {
+    std::vector<std::string> names;
+    for (int i = 0; i < dimension; i++) {
+        for (int j = 0; j <= dimension; j++) {
+            names.push_back(matrixCoefficientName(i, j, dimension));
+        }
+    }
+    return names;
+}
+
+class MatrixEngine {
+public:
+    size_t sharedWords = 0;
+
+    explicit MatrixEngine(int dimension) : dimension(dimension) {}
+
+    void declareSymbol(std::ostream& smtFile, char symbol) const {
+        for (const auto& name : matrixCoefficientNames(dimension)) {
+            smtFile << "(declare-fun " << name << "_" << symbol << " () Int)" << '\n';
+        }
+        for (const auto& name : matrixCoefficientNames(dimension)) {
+            smtFile << "(assert (>= " << name << "_" << symbol << " " << (name == "m0_0" ? 1 : 0) << "))" << '\n';
+        }
+    }
+
+    const std::vector<std::string>& word(std::ostream& smtFile, const std::string& word) {
+        auto it = words.find(word);
+        if (it != words.end()) {
+            sharedWords++;
+            return it->second;
+        }
+
+        size_t start = word.size() - 1;
+        const std::vector<std::string>* suffix = nullptr;
+        for (size_t k = 1; k < word.size() && suffix == nullptr; k++) {
+            auto cached = words.find(word.substr(k));
+            if (cached != words.end()) {
+                suffix = &cached->second;
+                start = k;
+            }
+        }
+        if (suffix == nullptr) {
+            suffix = &(words[word.substr(start)] = letterEntries(word[start]));
+        }
+
+        while (start > 0) {
+            start--;
+            suffix = &(words[word.substr(start)] = multiply(smtFile, letterEntries(word[start]), *suffix));
+        }
+        return *suffix;
+    }
+
+    std::string inequality(const std::vector<std::string>& lhs, const std::vector<std::string>& rhs, bool strict = true) const {
+        std::string expression = "(and";
+        for (int i = 0; i < dimension; i++) {
+            for (int j = 0; j <= dimension; j++) {
+                const char* comparator = strict && i == 0 && j == dimension ? ">" : ">=";
+                expression += " (" + std::string(comparator) + " " + lhs[entry(i, j)] + " " + rhs[entry(i, j)] + ")";
+            }
+        }
+        return expression + ")";
+    }
+
+    size_t size() const {
+        return words.size();
+    }
+
+private:
+    int dimension;
+    int definitions = 0;
+    std::unordered_map<std::string, std::vector<std::string>> words;
+
+    int entry(int row, int column) const {
+        return row * (dimension + 1) + column;
+    }
+
+    std::vector<std::string> letterEntries(char symbol) const {
+        std::vector<std::string> entries;
+        for (const auto& name : matrixCoefficientNames(dimension)) {
+            entries.push_back(name + "_" + symbol);
+        }
+        return entries;
+    }
+
+    std::vector<std::string> multiply(std::ostream& smtFile, const std::vector<std::string>& left, const std::vector<std::string>& right) {
+        int id = definitions++;
+        std::vector<std::string> product;
+        for (int i = 0; i < dimension; i++) {
+            for (int j = 0; j <= dimension; j++) {
+                std::vector<std::string> terms;
+                for (int k = 0; k < dimension; k++) {
+                    terms.push_back("(* " + left[entry(i, k)] + " " + right[entry(k, j)] + ")");
+                }
+                if (j == dimension) {
+                    terms.push_back(left[entry(i, dimension)]);
+                }
+
+                std::string name = "t" + std::to_string(id) + "." + std::to_string(i) + "." + std::to_string(j);
+                smtFile << "(define-fun " << name << " () Int ";
+                if (terms.size() == 1) {
+                    smtFile << terms[0];
+                } else {
+                    smtFile << "(+";
+                    for (const auto& term : terms) {
+                        smtFile << " " << term;
+                    }
+                    smtFile << ")";
+                }
+                smtFile << ")" << '\n';
+                product.push_back(name);
+            }
+        }
+        return product;
+    }
+};
+
+// Concrete matrices keep integer entries in doubles so that rows can be combined with packed multiply-adds; the
+// values stay exact as long as every entry is below 2^53, which multiplyMatrices checks after each product.
+const double exactMatrixLimit = 9007199254740992.0;
+
+class ConcreteMatrix {
+public:
+    int size = 0;
+    int stride = 0;
+    std::vector<double> entries;
+
+    ConcreteMatrix() = default;
+    explicit ConcreteMatrix(int size) : size(size), stride((size + 3) / 4 * 4), entries(size * stride, 0.0) {}
+
+    double& at(int row, int column) {
+        return entries[row * stride + column];
+    }
+
+    double at(int row, int column) const {
+        return entries[row * stride + column];
+    }
+};
+
+bool multiplyMatrices(const ConcreteMatrix& left, const ConcreteMatrix& right, ConcreteMatrix& product) {
+    int stride = product.stride;
+    std::fill(product.entries.begin(), product.entries.end(), 0.0);
+
+    for (int i = 0; i < left.size; i++) {
+        double* row = &product.entries[i * stride];
+        for (int k = 0; k < left.size; k++) {
+            double factor = left.at(i, k);
+            if (factor == 0.0) {
+                continue;
+            }
+            const double* source = &right.entries[k * stride];
+#if defined(__AVX__)
+            __m256d factors = _mm256_set1_pd(factor);
+            for (int j = 0; j < stride; j += 4) {
+                _mm256_storeu_pd(row + j, _mm256_add_pd(_mm256_loadu_pd(row + j), _mm256_mul_pd(factors, _mm256_loadu_pd(source + j))));
+            }
+#elif defined(__SSE2__)
+            __m128d factors = _mm_set1_pd(factor);
+            for (int j = 0; j < stride; j += 2) {
+                _mm_storeu_pd(row + j, _mm_add_pd(_mm_loadu_pd(row + j), _mm_mul_pd(factors, _mm_loadu_pd(source + j))));
+            }
+#else
+            for (int j = 0; j < stride; j++) {
+                row[j] += factor * source[j];
+            }
+#endif
+        }
+    }
+
+    for (double value : product.entries) {
+        if (value >= exactMatrixLimit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class MatrixLetters {
+public:
+    int dimension;
+    std::map<char, ConcreteMatrix> letters;
+
+    explicit MatrixLetters(int dimension) : dimension(dimension) {}
+
+    ConcreteMatrix& letter(char symbol) {
+        auto it = letters.find(symbol);
+        if (it == letters.end()) {
+            it = letters.emplace(symbol, ConcreteMatrix(dimension + 1)).first;
+            it->second.at(dimension, dimension) = 1.0;
+        }
+        return it->second;
+    }
+
+    // result := [word]; returns false when the product is no longer exact
+    bool compose(const std::string& word, ConcreteMatrix& result, ConcreteMatrix& scratch) const {
+        result = letters.at(word.back());
+        for (auto symbol = word.crbegin() + 1; symbol != word.crend(); ++symbol) {
+            if (!multiplyMatrices(letters.at(*symbol), result, scratch)) {
+                return false;
+            }
+            std::swap(result.entries, scratch.entries);
+        }
+        return true;
+    }
+};
+
+bool matrixDecreasing(const ConcreteMatrix& lhs, const ConcreteMatrix& rhs, int dimension, bool strict = true) {
+    for (int i = 0; i < dimension; i++) {
+        for (int j = 0; j <= dimension; j++) {
+            if (lhs.at(i, j) < rhs.at(i, j)) {
+                return false;
+            }
+        }
+    }
+    return !strict || lhs.at(0, dimension) > rhs.at(0, dimension);
+}
+
+// As verifyModel, rule i only has to decrease weakly when weak[i] is set.
+Verification verifyMatrixModel(const RuleSystem& system, const Model& model, int dimension, const std::vector<bool>& weak = {}) {
+    MatrixLetters letters(dimension);
+    std::set<char> inexact;
+    for (const auto& rule : system.rules) {
+        for (const std::string* side : { &rule.first, &rule.second }) {
+            for (char symbol : *side) {
+                ConcreteMatrix& letter = letters.letter(symbol);
+                for (int i = 0; i < dimension; i++) {
+                    for (int j = 0; j <= dimension; j++) {
+                        long long value = 0;
+                        model.get(symbol, matrixCoefficientName(i, j, dimension), value);
+                        if (std::abs(static_cast<double>(value)) >= exactMatrixLimit) {
+                            inexact.insert(symbol);
+                        }
+                        letter.at(i, j) = static_cast<double>(value);
+                    }
+                }
+            }
+        }
+    }
+
+    // Entries from 2^53 on are rounded when they are converted to double, so the letters with one are not checked.
+    auto unchecked = [&model, &inexact](const std::string& word) {
+        return model.overflows(word) || std::any_of(word.begin(), word.end(), [&inexact](char symbol) { return inexact.count(symbol) != 0; });
+    };
+
+    Verification verification;
+    ConcreteMatrix lhs(dimension + 1);
+    ConcreteMatrix rhs(dimension + 1);
+    ConcreteMatrix scratch(dimension + 1);
+    for (size_t i = 0; i < system.rules.size(); i++) {
+        if (unchecked(system.rules[i].first) || unchecked(system.rules[i].second)
+            || !letters.compose(system.rules[i].first, lhs, scratch) || !letters.compose(system.rules[i].second, rhs, scratch)) {
+            verification.inconclusive.push_back(i);
+        } else if (!matrixDecreasing(lhs, rhs, dimension, weak.empty() || !weak[i])) {
+            verification.failed.push_back(i);
+        }
+    }
+    return verification;
+}
+
+// Enumerates every interpretation with entries in [0, bound] (the upper left entry in [1, bound]) until one
+// orients all rules or limit candidates have been tried.
+bool searchMatrixInterpretation(const RuleSystem& system, int dimension, int bound, long long limit, Model& model) {
+    MatrixLetters letters(dimension);
+    std::vector<char> symbols;
+    for (const auto& rule : system.rules) {
+        for (const std::string* side : { &rule.first, &rule.second }) {
+            for (char symbol : *side) {
+                if (std::find(symbols.begin(), symbols.end(), symbol) == symbols.end()) {
+                    symbols.push_back(symbol);
+                    letters.letter(symbol);
+                }
+            }
+        }
+    }
+
+    int perLetter = dimension * (dimension + 1);
+    std::vector<int> values(symbols.size() * perLetter, 0);
+    std::vector<int> minimum(values.size(), 0);
+    for (size_t s = 0; s < symbols.size(); s++) {
+        minimum[s * perLetter] = 1;
+        values[s * perLetter] = 1;
+    }
+
+    ConcreteMatrix lhs(dimension + 1);
+    ConcreteMatrix rhs(dimension + 1);
+    ConcreteMatrix scratch(dimension + 1);
+    size_t firstFailing = 0;
+
+    for (long long candidate = 0; candidate < limit; candidate++) {
+        for (size_t s = 0; s < symbols.size(); s++) {
+            ConcreteMatrix& letter = letters.letter(symbols[s]);
+            for (int k = 0; k < perLetter; k++) {
+                letter.at(k / (dimension + 1), k % (dimension + 1)) = values[s * perLetter + k];
+            }
+        }
+
+        bool oriented = true;
+        for (size_t r = 0; r < system.rules.size() && oriented; r++) {
+            size_t rule = (firstFailing + r) % system.rules.size();
+            if (!letters.compose(system.rules[rule].first, lhs, scratch)
+                || !letters.compose(system.rules[rule].second, rhs, scratch)
+                || !matrixDecreasing(lhs, rhs, dimension)) {
+                oriented = false;
+                firstFailing = rule;
+            }
+        }
+
+        if (oriented) {
+            model.clear();
+            for (size_t s = 0; s < symbols.size(); s++) {
+                for (int k = 0; k < perLetter; k++) {
+                    model.coefficients[symbols[s]][matrixCoefficientName(k / (dimension + 1), k % (dimension + 1), dimension)] = values[s * perLetter + k];
+                }
+            }
+            return true;
+        }
+
+        size_t position = 0;
+        while (position < values.size() && values[position] == bound) {
+            values[position] = minimum[position];
+            position++;
+        }
+        if (position == values.size()) {
+            return false;
+        }
+        values[position]++;
+    }
+
+    return false;
+}
+
+#endif //FLT1_MATRIXINTERPRETATION_H
@@ -0,0 +1,57 @@
+#ifndef FLT1_MODELVERIFICATION_H
+#define FLT1_MODELVERIFICATION_H
+
+class Verification {
+public:
+    std::vector<size_t> failed;
+    std::vector<size_t> inconclusive;
+};
+
+bool saturated(const OrdinalWord<long long>& word) {
+    return std::find(word.factor.begin(), word.factor.end(), saturatedCoefficient) != word.factor.end()
+           || std::find(word.constant.begin(), word.constant.end(), saturatedCoefficient) != word.constant.end();
+}
+
+bool strictlyDecreasing(const OrdinalWord<long long>& lhs, const OrdinalWord<long long>& rhs) {
+    int factor = compareOrdinals(lhs.factor, rhs.factor);
+    int constant = compareOrdinals(lhs.constant, rhs.constant);
+    return (factor > 0 && constant >= 0) || (factor == 0 && constant > 0);
+}
+
+bool weaklyDecreasing(const OrdinalWord<long long>& lhs, const OrdinalWord<long long>& rhs) {
+    return compareOrdinals(lhs.factor, rhs.factor) >= 0 && compareOrdinals(lhs.constant, rhs.constant) >= 0;
+}
+
+// Rule i only has to decrease weakly when weak[i] is set; an empty weak asks every rule to decrease strictly.
+Verification verifyModel(const RuleSystem& system, const Model& model, int degree, const std::vector<bool>& weak = {}) {
+    std::map<char, OrdinalLetter<long long>> letters;
+    for (const auto& rule : system.rules) {
+        for (const std::string* side : { &rule.first, &rule.second }) {
+            for (char symbol : *side) {
+                if (letters.count(symbol) == 0) {
+                    letters.emplace(symbol, makeLetter<long long>(degree, symbol, [&model](char s, const std::string& name) {
+                        long long value = 0;
+                        model.get(s, name, value);
+                        return value;
+                    }));
+                }
+            }
+        }
+    }
+
+    Verification verification;
+    OrdinalWord<long long> lhs;
+    OrdinalWord<long long> rhs;
+    for (size_t i = 0; i < system.rules.size(); i++) {
+        composeWord(system.rules[i].first, letters, lhs);
+        composeWord(system.rules[i].second, letters, rhs);
+        if (model.overflows(system.rules[i].first) || model.overflows(system.rules[i].second) || saturated(lhs) || saturated(rhs)) {
+            verification.inconclusive.push_back(i);
+        } else if (!(!weak.empty() && weak[i] ? weaklyDecreasing(lhs, rhs) : strictlyDecreasing(lhs, rhs))) {
+            verification.failed.push_back(i);
+        }
+    }
+    return verification;
+}
+
+#endif //FLT1_MODELVERIFICATION_H
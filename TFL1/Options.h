@@ -0,0 +1,139 @@
+#ifndef FLT1_OPTIONS_H
+#define FLT1_OPTIONS_H
+
+enum class Engine { Ordinal, Matrix };
+
+class Options {
+public:
+    Engine engine = Engine::Ordinal;
+    int degree = 0;
+    int dimension = 2;
+    int searchBound = 0;
+    bool verbose = false;
+    bool ruleRemoval = false;
+    bool precheck = false;
+    bool findLoops = false;
+    bool raceReversed = false;
+    int loopStates = 1000000;
+    std::string smtPath;
+    std::string fallbackPath = "inequalities.smt2";
+    std::string corpus;
+    int workers = -1;
+    int shardSize = 16;
+    int timeout = 60;
+    std::string listen = "127.0.0.1:0";
+    std::string worker;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--engine ordinal|matrix] [--degree N] [--dimension N] [--search N] [--remove-rules] [--precheck] [--loops [--loop-states N]] [--reversed] [--smt2 FILE] [--verbose]" << std::endl;
+    std::cout << "       " << program << " --corpus FILE [--workers N] [--shard-size N] [--timeout S] [--listen HOST:PORT] [engine options]" << std::endl;
+    std::cout << "       " << program << " --worker HOST:PORT [engine options]" << std::endl;
+    std::cout << "  --engine E      prove termination with ordinal (default) or matrix interpretations" << std::endl;
+    std::cout << "  --degree N      interpret letters with the w-degree N template instead of (w*a + b) * x + w*c + d" << std::endl;
+    std::cout << "  --dimension N   size of the matrices used by the matrix engine (default 2)" << std::endl;
+    std::cout << "  --search N      try all matrices with entries up to N before calling the solver" << std::endl;
+    std::cout << "  --remove-rules  remove the rules that some interpretation decreases strictly, round after round" << std::endl;
+    std::cout << "  --precheck      give every rule to the solver on its own first and stop at one that fails" << std::endl;
+    std::cout << "  --loops         search for a looping derivation while the solver runs (not with --remove-rules)" << std::endl;
+    std::cout << "  --loop-states N words the loop search may visit over all rules together (default 1000000)" << std::endl;
+    std::cout << "  --reversed      also solve the system with every rule reversed and keep the first proof" << std::endl;
+    std::cout << "  --smt2 FILE     also write the problem sent to the solver to FILE" << std::endl;
+    std::cout << "  --verbose       print the interpretation of both sides of every rule" << std::endl;
+    std::cout << "  --corpus FILE   check every rule system listed in FILE (one path per line) with worker processes" << std::endl;
+    std::cout << "  --workers N     number of local workers to start (default: one per core, 0 waits for remote ones)" << std::endl;
+    std::cout << "  --shard-size N  number of rule systems handed to a worker at once (default 16)" << std::endl;
+    std::cout << "  --timeout S     seconds a worker may spend on one rule system before it is restarted (default 60)" << std::endl;
+    std::cout << "  --listen A      address the coordinator accepts workers on (default 127.0.0.1:0)" << std::endl;
+    std::cout << "  --worker A      serve rule systems for the coordinator listening on A" << std::endl;
+}
+
+bool parseNumber(const char* text, int minimum, int& value) {
+    char* end = nullptr;
+    long number = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || number < minimum || number > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    value = static_cast<int>(number);
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--verbose") {
+            options.verbose = true;
+            continue;
+        }
+        if (argument == "--remove-rules") {
+            options.ruleRemoval = true;
+            continue;
+        }
+        if (argument == "--precheck") {
+            options.precheck = true;
+            continue;
+        }
+        if (argument == "--loops") {
+            options.findLoops = true;
+            continue;
+        }
+        if (argument == "--reversed") {
+            options.raceReversed = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            return false;
+        }
+        if (argument == "--engine") {
+            std::string engine = argv[++i];
+            if (engine == "ordinal") {
+                options.engine = Engine::Ordinal;
+            } else if (engine == "matrix") {
+                options.engine = Engine::Matrix;
+            } else {
+                return false;
+            }
+        } else if (argument == "--degree") {
+            if (!parseNumber(argv[++i], 1, options.degree)) {
+                return false;
+            }
+        } else if (argument == "--dimension") {
+            if (!parseNumber(argv[++i], 1, options.dimension)) {
+                return false;
+            }
+        } else if (argument == "--search") {
+            if (!parseNumber(argv[++i], 1, options.searchBound)) {
+                return false;
+            }
+        } else if (argument == "--loop-states") {
+            if (!parseNumber(argv[++i], 1, options.loopStates)) {
+                return false;
+            }
+        } else if (argument == "--smt2") {
+            options.smtPath = argv[++i];
+        } else if (argument == "--corpus") {
+            options.corpus = argv[++i];
+        } else if (argument == "--workers") {
+            if (!parseNumber(argv[++i], 0, options.workers)) {
+                return false;
+            }
+        } else if (argument == "--shard-size") {
+            if (!parseNumber(argv[++i], 1, options.shardSize)) {
+                return false;
+            }
+        } else if (argument == "--timeout") {
+            if (!parseNumber(argv[++i], 1, options.timeout)) {
+                return false;
+            }
+        } else if (argument == "--listen") {
+            options.listen = argv[++i];
+        } else if (argument == "--worker") {
+            options.worker = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return !(options.findLoops && options.ruleRemoval);
+}
+
+#endif //FLT1_OPTIONS_H
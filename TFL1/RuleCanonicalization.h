@@ -0,0 +1,112 @@
+#ifndef FLT1_RULECANONICALIZATION_H
+#define FLT1_RULECANONICALIZATION_H
+
+class RuleSystem {
+public:
+    std::vector<std::pair<std::string, std::string>> rules;
+    std::vector<std::string> malformed;
+    size_t duplicateRules = 0;
+};
+
+std::string canonicalizeWord(const std::string& word) {
+    std::string canonical;
+    canonical.reserve(word.size());
+    for (char c : word) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            canonical += c;
+        }
+    }
+    return canonical;
+}
+
+void addRule(RuleSystem& system, std::set<std::pair<std::string, std::string>>& seen, const std::string& lhs, const std::string& rhs) {
+    std::pair<std::string, std::string> rule = { canonicalizeWord(lhs), canonicalizeWord(rhs) };
+    if (seen.insert(rule).second) {
+        system.rules.push_back(rule);
+    } else {
+        system.duplicateRules++;
+    }
+}
+
+RuleSystem readRuleSystem(std::istream& input) {
+    RuleSystem system;
+    std::set<std::pair<std::string, std::string>> seen;
+    std::string line;
+
+    while (std::getline(input, line)) {
+        if (canonicalizeWord(line).empty()) {
+            continue;
+        }
+
+        size_t arrow_pos = line.find("->");
+        if (arrow_pos == std::string::npos
+            || canonicalizeWord(line.substr(0, arrow_pos)).empty()
+            || canonicalizeWord(line.substr(arrow_pos + 2)).empty()) {
+            system.malformed.push_back(line);
+            continue;
+        }
+
+        std::pair<std::string, std::string> sides = parseInput(line);
+        addRule(system, seen, sides.first, sides.second);
+    }
+
+    return system;
+}
+
+RuleSystem makeRuleSystem(const std::vector<std::pair<std::string, std::string>>& rules) {
+    RuleSystem system;
+    std::set<std::pair<std::string, std::string>> seen;
+    for (const auto& rule : rules) {
+        if (canonicalizeWord(rule.first).empty() || canonicalizeWord(rule.second).empty()) {
+            system.malformed.push_back(rule.first + " -> " + rule.second);
+        } else {
+            addRule(system, seen, rule.first, rule.second);
+        }
+    }
+    return system;
+}
+
+// Both sides of every rule read backwards. The mirror image terminates exactly when the system does.
+RuleSystem reverseRuleSystem(const RuleSystem& system) {
+    RuleSystem reversed = system;
+    for (auto& rule : reversed.rules) {
+        std::reverse(rule.first.begin(), rule.first.end());
+        std::reverse(rule.second.begin(), rule.second.end());
+    }
+    return reversed;
+}
+
+class WordInterpretation {
+public:
+    std::map<std::pair<int, bool>, std::string> coefficients;
+};
+
+// Without a degree the letters use (w*a + b) * x + w*c + d, which is the degree 1 template.
+class InterpretationCache {
+public:
+    size_t sharedWords = 0;
+
+    explicit InterpretationCache(int degree = 0) : degree(std::max(degree, 1)) {}
+
+    const WordInterpretation& get(const std::string& word) {
+        auto it = words.find(word);
+        if (it != words.end()) {
+            sharedWords++;
+            return it->second;
+        }
+
+        WordInterpretation& interpretation = words[word];
+        interpretation.coefficients = templateCoefficients(word, degree);
+        return interpretation;
+    }
+
+    size_t size() const {
+        return words.size();
+    }
+
+private:
+    int degree;
+    std::unordered_map<std::string, WordInterpretation> words;
+};
+
+#endif //FLT1_RULECANONICALIZATION_H
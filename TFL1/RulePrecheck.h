@@ -0,0 +1,62 @@
+#ifndef FLT1_RULEPRECHECK_H
+#define FLT1_RULEPRECHECK_H
+
+// A rule that cannot be oriented on its own cannot be oriented together with the others either. A right-hand side
+// that contains the left-hand side is the cheap case: interpretations of letters never decrease their argument, so
+// the context around the copy can only add to it.
+bool containsLeftSide(const std::pair<std::string, std::string>& rule) {
+    return rule.second.find(rule.first) != std::string::npos;
+}
+
+// Returns the index of a rule that cannot be oriented, or system.rules.size() when there is none. With solve set the
+// rules that pass the syntactic test are also given to the solver one by one, on as many threads as there are cores,
+// and the first unsat answer stops the solvers that are still running.
+size_t findHopelessRule(const RuleSystem& system, const Options& options, bool solve, std::string& reason) {
+    for (size_t i = 0; i < system.rules.size(); i++) {
+        if (containsLeftSide(system.rules[i])) {
+            reason = "its right-hand side contains its left-hand side";
+            return i;
+        }
+    }
+    if (!solve || system.rules.size() < 2) {
+        return system.rules.size();
+    }
+
+    Options single = options;
+    single.verbose = false;
+    single.smtPath.clear();
+
+    std::atomic<size_t> next(0);
+    std::atomic<bool> found(false);
+    std::mutex mutex;
+    std::vector<SolverCancellation> cancellations(system.rules.size());
+    size_t hopeless = system.rules.size();
+    auto work = [&]() {
+        size_t i;
+        while (!found && (i = next++) < system.rules.size()) {
+            RuleSystem rule;
+            rule.rules.push_back(system.rules[i]);
+            Options ruleOptions = single;
+            ruleOptions.fallbackPath = "inequalities" + std::to_string(i) + ".smt2";
+            if (checkRuleSystem(rule, ruleOptions, &cancellations[i]) == Verdict::Unsat) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!found) {
+                    hopeless = i;
+                    found = true;
+                    for (auto& cancellation : cancellations) {
+                        cancellation.cancel();
+                    }
+                }
+            }
+        }
+    };
+
+    runOnCores(system.rules.size(), work);
+
+    if (hopeless < system.rules.size()) {
+        reason = "the solver finds no interpretation for it alone (unsat)";
+    }
+    return hopeless;
+}
+
+#endif //FLT1_RULEPRECHECK_H
@@ -0,0 +1,272 @@
+#ifndef FLT1_SEXPRESSIONPARSER_H
+#define FLT1_SEXPRESSIONPARSER_H
+
+class SolverResult {
+public:
+    Verdict verdict = Verdict::None;
+    Model model;
+    std::vector<std::string> errors;
+};
+
+class SExpressionReader {
+public:
+    explicit SExpressionReader(SolverResult& result) : result(result) {}
+
+    void feed(const char* data, size_t size) {
+        const char* end = data + size;
+        const char* cursor = data;
+
+        while (cursor != end) {
+            if (state == State::Comment) {
+                const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+                if (newline == nullptr) {
+                    return;
+                }
+                state = State::Between;
+                cursor = newline + 1;
+                continue;
+            }
+
+            if (stringQuoteAtEnd) {
+                stringQuoteAtEnd = false;
+                if (*cursor == '"') {
+                    ++cursor;
+                    continue;
+                }
+                pending.pop_back();
+                item(Token::String, pending.data(), pending.size());
+                pending.clear();
+                state = State::Between;
+                continue;
+            }
+
+            if (state == State::String || state == State::QuotedSymbol) {
+                char quote = state == State::String ? '"' : '|';
+                const char* closing = static_cast<const char*>(std::memchr(cursor, quote, end - cursor));
+                if (closing == nullptr) {
+                    pending.append(cursor, end);
+                    return;
+                }
+                if (state == State::String && closing + 1 == end) {
+                    pending.append(cursor, closing + 1);
+                    stringQuoteAtEnd = true;
+                    return;
+                }
+                if (state == State::String && closing[1] == '"') {
+                    pending.append(cursor, closing + 1);
+                    cursor = closing + 2;
+                    continue;
+                }
+                pending.append(cursor, closing);
+                if (state == State::String) {
+                    item(Token::String, pending.data(), pending.size());
+                } else {
+                    item(Token::Atom, pending.data(), pending.size());
+                }
+                pending.clear();
+                state = State::Between;
+                cursor = closing + 1;
+                continue;
+            }
+
+            if (state == State::Atom) {
+                const char* atomEnd = cursor;
+                while (atomEnd != end && !isDelimiter(*atomEnd)) {
+                    ++atomEnd;
+                }
+                if (atomEnd == end) {
+                    pending.append(cursor, end);
+                    return;
+                }
+                if (pending.empty()) {
+                    item(Token::Atom, cursor, atomEnd - cursor);
+                } else {
+                    pending.append(cursor, atomEnd);
+                    item(Token::Atom, pending.data(), pending.size());
+                    pending.clear();
+                }
+                state = State::Between;
+                cursor = atomEnd;
+                continue;
+            }
+
+            char c = *cursor;
+            if (c == '(') {
+                frames.emplace_back();
+                ++cursor;
+            } else if (c == ')') {
+                closeList();
+                ++cursor;
+            } else if (c == ';') {
+                state = State::Comment;
+                ++cursor;
+            } else if (c == '"') {
+                state = State::String;
+                ++cursor;
+            } else if (c == '|') {
+                state = State::QuotedSymbol;
+                ++cursor;
+            } else if (std::isspace(static_cast<unsigned char>(c))) {
+                ++cursor;
+            } else {
+                state = State::Atom;
+            }
+        }
+    }
+
+    void feed(const std::string& data) {
+        feed(data.data(), data.size());
+    }
+
+    void finish() {
+        if (stringQuoteAtEnd) {
+            stringQuoteAtEnd = false;
+            pending.pop_back();
+            item(Token::String, pending.data(), pending.size());
+        } else if (state == State::Atom && !pending.empty()) {
+            item(Token::Atom, pending.data(), pending.size());
+        }
+        pending.clear();
+        state = State::Between;
+    }
+
+    bool complete() const {
+        return frames.empty() && state == State::Between && pending.empty();
+    }
+
+    // reached() turns true once a top-level atom equal to marker has been read, e.g. the output of (echo "marker").
+    void expect(const std::string& text) {
+        marker = text;
+        marked = false;
+    }
+
+    bool reached() const {
+        return marked;
+    }
+
+private:
+    enum class State { Between, Atom, String, QuotedSymbol, Comment };
+    enum class Token { Atom, String };
+    enum class Kind { Plain, DefineFun, Negation, Error };
+
+    struct Frame {
+        Kind kind = Kind::Plain;
+        int position = 0;
+        bool hasValue = false;
+        bool overflow = false;
+        long long value = 0;
+        std::string name;
+    };
+
+    SolverResult& result;
+    std::vector<Frame> frames;
+    std::string pending;
+    State state = State::Between;
+    bool stringQuoteAtEnd = false;
+    std::string marker;
+    bool marked = false;
+
+    static bool isDelimiter(char c) {
+        return c == '(' || c == ')' || c == '"' || c == '|' || c == ';' || std::isspace(static_cast<unsigned char>(c));
+    }
+
+    static bool equals(const char* text, size_t length, const char* literal) {
+        return std::strlen(literal) == length && std::memcmp(text, literal, length) == 0;
+    }
+
+    // Fails for atoms that are not numbers, and for numbers beyond the range of long long, which also set overflow.
+    static bool parseNumber(const char* text, size_t length, long long& value, bool& overflow) {
+        overflow = false;
+        if (length == 0) {
+            return false;
+        }
+        if (equals(text, length, "true")) {
+            value = 1;
+            return true;
+        }
+        if (equals(text, length, "false")) {
+            value = 0;
+            return true;
+        }
+        long long number = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+            int digit = text[i] - '0';
+            if (number > (std::numeric_limits<long long>::max() - digit) / 10) {
+                overflow = true;
+                return false;
+            }
+            number = number * 10 + digit;
+        }
+        value = number;
+        return true;
+    }
+
+    void item(Token token, const char* text, size_t length) {
+        if (frames.empty()) {
+            if (token != Token::Atom) {
+                return;
+            }
+            if (!marker.empty() && equals(text, length, marker.c_str())) {
+                marked = true;
+            } else if (equals(text, length, "sat")) {
+                result.verdict = Verdict::Sat;
+            } else if (equals(text, length, "unsat")) {
+                result.verdict = Verdict::Unsat;
+            } else if (equals(text, length, "unknown")) {
+                result.verdict = Verdict::Unknown;
+            }
+            return;
+        }
+
+        Frame& frame = frames.back();
+        if (frame.position == 0 && token == Token::Atom) {
+            if (equals(text, length, "define-fun")) {
+                frame.kind = Kind::DefineFun;
+            } else if (equals(text, length, "-")) {
+                frame.kind = Kind::Negation;
+            } else if (equals(text, length, "error")) {
+                frame.kind = Kind::Error;
+            }
+        } else if (frame.kind == Kind::DefineFun && frame.position == 1 && token == Token::Atom) {
+            frame.name.assign(text, length);
+        } else if (frame.kind == Kind::DefineFun && frame.position == 4 && token == Token::Atom) {
+            frame.hasValue = parseNumber(text, length, frame.value, frame.overflow);
+        } else if (frame.kind == Kind::Negation && frame.position == 1 && token == Token::Atom) {
+            frame.hasValue = parseNumber(text, length, frame.value, frame.overflow);
+            frame.value = -frame.value;
+        } else if (frame.kind == Kind::Error && frame.position == 1 && token == Token::String) {
+            result.errors.emplace_back(text, length);
+        }
+        frame.position++;
+    }
+
+    void closeList() {
+        if (frames.empty()) {
+            return;
+        }
+        Frame closed = std::move(frames.back());
+        frames.pop_back();
+
+        if (closed.kind == Kind::DefineFun && closed.hasValue && !closed.name.empty()) {
+            result.model.assign(closed.name, closed.value);
+        } else if (closed.kind == Kind::DefineFun && closed.overflow && !closed.name.empty()) {
+            result.model.assignOverflow(closed.name);
+        }
+
+        if (frames.empty()) {
+            return;
+        }
+        Frame& parent = frames.back();
+        if (parent.kind == Kind::DefineFun && parent.position == 4 && closed.kind == Kind::Negation) {
+            parent.hasValue = closed.hasValue;
+            parent.overflow = closed.overflow;
+            parent.value = closed.value;
+        }
+        parent.position++;
+    }
+};
+
+#endif //FLT1_SEXPRESSIONPARSER_H
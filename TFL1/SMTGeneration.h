@@ -2,135 +2,421 @@
 #define FLT1_SMTGENERATION_H
 
 #include <iostream>
-#include <map>
-#include <vector>
-#include <sstream>
 #include <fstream>
-#include <algorithm>
-#include <cassert>
-#include "LinearFunction.h"
-#include "InequalitiesGeneration.h"
-#include "LinearFunctionsGeneration.h"
+#include <cstdio>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#if defined(__unix__) || defined(__APPLE__)
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#endif
+#include "ConstraintGeneration.h"
+#include "Options.h"
 
-std::pair<std::string, std::string> parseInput(const std::string& input) {
-    size_t arrow_pos = input.find("->");
-    std::string lhs = input.substr(0, arrow_pos);
-    std::string rhs = input.substr(arrow_pos + 2);
+const char* const solverProgram = "z3.exe";
 
-    lhs = lhs.substr(lhs.find_first_not_of(' '));
-    lhs = lhs.substr(0, lhs.find_last_not_of(' ') + 1);
+bool executeSMTSolver(const std::string& smtFile, SolverResult& result) {
+    std::stringstream command;
+    command << solverProgram << " -smt2 " << smtFile;
+
+    FILE* pipe = popen(command.str().c_str(), "r");
+    if (!pipe) {
+        return false;
+    }
 
-    rhs = rhs.substr(rhs.find_first_not_of(' '));
-    rhs = rhs.substr(0, rhs.find_last_not_of(' ') + 1);
+    SExpressionReader reader(result);
+    std::vector<char> buffer(1 << 16);
+    size_t size;
+    while ((size = fread(buffer.data(), 1, buffer.size(), pipe)) > 0) {
+        reader.feed(buffer.data(), size);
+    }
+    reader.finish();
 
-    return { lhs, rhs };
+    // The shell reports a missing solver only through the exit status.
+    int status = pclose(pipe);
+    return result.verdict != Verdict::None || status == 0;
 }
 
-void generateRequirements(std::ofstream& smtFile, std::vector<char>& symbols, const std::pair<std::string, std::string>& sides, const std::map<std::pair<int, bool>, std::string>& lhs, const std::map<std::pair<int, bool>, std::string>& rhs) {
-    for (auto symbol : sides.first) {
-        if (std::find(symbols.begin(), symbols.end(), symbol) == symbols.end()) {
-            smtFile << "(declare-fun a_" << symbol << " () Int)" << std::endl;
-            smtFile << "(declare-fun b_" << symbol << " () Int)" << std::endl;
-            smtFile << "(declare-fun c_" << symbol << " () Int)" << std::endl;
-            smtFile << "(declare-fun d_" << symbol << " () Int)" << std::endl;
-            smtFile << "(assert (> a_" << symbol << " 0))" << std::endl;
-            smtFile << "(assert (> b_" << symbol << " 0))" << std::endl;
-            smtFile << "(assert (> c_" << symbol << " 0))" << std::endl;
-            smtFile << "(assert (> d_" << symbol << " 0))" << std::endl;
-            symbols.emplace_back(symbol);
+void printModel(const Model& model) {
+    for (const auto& symbol : model.coefficients) {
+        std::cout << symbol.first << ":";
+        std::string separator = " ";
+        for (const auto& coefficient : symbol.second) {
+            std::cout << separator << coefficient.first << " = " << coefficient.second;
+            separator = ", ";
         }
+        std::cout << std::endl;
+    }
+    for (const auto& value : model.values) {
+        std::cout << value.first << " = " << value.second << std::endl;
     }
+}
 
-    for (auto symbol : sides.second) {
-        if (std::find(symbols.begin(), symbols.end(), symbol) == symbols.end()) {
-            smtFile << "(declare-fun a_" << symbol << " () Int)" << std::endl;
-            smtFile << "(declare-fun b_" << symbol << " () Int)" << std::endl;
-            smtFile << "(declare-fun c_" << symbol << " () Int)" << std::endl;
-            smtFile << "(declare-fun d_" << symbol << " () Int)" << std::endl;
-            smtFile << "(assert (> a_" << symbol << " 0))" << std::endl;
-            smtFile << "(assert (> b_" << symbol << " 0))" << std::endl;
-            smtFile << "(assert (> c_" << symbol << " 0))" << std::endl;
-            smtFile << "(assert (> d_" << symbol << " 0))" << std::endl;
-            symbols.emplace_back(symbol);
-        }
+// The reasons the solver gave, e.g. for a command it could not parse, when it answered neither sat nor unsat.
+void printSolverErrors(const SolverResult& result) {
+    if (result.verdict == Verdict::Sat || result.verdict == Verdict::Unsat) {
+        return;
+    }
+    for (const auto& error : result.errors) {
+        std::cout << "Solver error: " << error << std::endl;
     }
+}
 
-    /*std::vector<std::string> inequalities = generateInequalities(lhs, rhs);
+void printInterpretation(std::ostream& os, const WordInterpretation& interpretation) {
+    printCoefficients(os, interpretation.coefficients);
+    os << '\n';
+}
 
-    for (const auto& inequality : inequalities) {
-        smtFile << "(assert " << inequality << ")" << std::endl;
-    }*/
+void reportVerification(const RuleSystem& system, const Verification& verification) {
+    for (size_t i : verification.failed) {
+        std::cout << "The model does not orient rule " << system.rules[i].first << " -> " << system.rules[i].second << "." << std::endl;
+    }
+    for (size_t i : verification.inconclusive) {
+        std::cout << "The model could not be checked on rule " << system.rules[i].first << " -> " << system.rules[i].second << " (coefficient overflow)." << std::endl;
+    }
+}
 
-    std::string inequality = generateInequalities(lhs, rhs);
-    smtFile << "(assert " << inequality << ")" << std::endl;
+// Checks a model of the solver on the rules it was found for, which are the reversed rules when reversed is set.
+Verification verifySolution(const RuleSystem& system, const Options& options, const Model& model, bool reversed) {
+    const RuleSystem proved = reversed ? reverseRuleSystem(system) : system;
+    if (options.engine == Engine::Matrix) {
+        return verifyMatrixModel(proved, model, options.dimension);
+    }
+    return verifyModel(proved, model, std::max(options.degree, 1));
+}
 
+class GenerationStatistics {
+public:
+    size_t words = 0;
+    size_t sharedWords = 0;
+    size_t constraints = 0;
+    size_t sharedConstraints = 0;
+};
+
+GenerationStatistics writeConstraints(std::ostream& smtFile, const RuleSystem& system, const Options& options, bool removal = false) {
+    std::vector<char> symbols = {};
+    std::unordered_set<std::string> constraints;
+    InterpretationCache interpretations(options.degree);
+    MatrixEngine matrices(options.dimension);
+    std::vector<std::string> coefficientNames = templateCoefficientNames(std::max(options.degree, 1));
+    GenerationStatistics statistics;
+
+    smtFile << "(set-logic QF_NIA)" << '\n';
+    for (size_t i = 0; i < system.rules.size() && smtFile; i++) {
+        const auto& sides = system.rules[i];
+        int indicator = removal ? static_cast<int>(i) : -1;
+        bool emitted;
+        if (options.engine == Engine::Matrix) {
+            emitted = generateMatrixRequirements(smtFile, smtFile, symbols, constraints, matrices, sides, indicator);
+        } else {
+            const WordInterpretation& lhs = interpretations.get(sides.first);
+            const WordInterpretation& rhs = interpretations.get(sides.second);
+            if (options.verbose) {
+                printInterpretation(std::cout, lhs);
+                printInterpretation(std::cout, rhs);
+            }
+            emitted = generateRequirements(smtFile, smtFile, symbols, constraints, coefficientNames, sides, lhs.coefficients, rhs.coefficients, indicator);
+        }
+        if (!emitted) {
+            statistics.sharedConstraints++;
+        }
+    }
+    if (removal && !system.rules.empty()) {
+        smtFile << "(assert (or";
+        for (size_t i = 0; i < system.rules.size(); i++) {
+            smtFile << " strict" << i;
+        }
+        smtFile << "))" << '\n';
+    }
+    smtFile << "(check-sat)" << '\n';
+    smtFile << "(get-model)" << '\n';
+
+    statistics.words = options.engine == Engine::Matrix ? matrices.size() : interpretations.size();
+    statistics.sharedWords = options.engine == Engine::Matrix ? matrices.sharedWords : interpretations.sharedWords;
+    statistics.constraints = constraints.size();
+    return statistics;
 }
 
-bool executeSMTSolver(const std::string& smtFile, std::string& output) {
-    std::stringstream command;
-    command << R"(z3.exe -smt2 )" << smtFile;
+// The constraints are written into the stdin of the solver while they are generated, and into options.smtPath as
+// well when it is set. Where no solver process can be started they go through a file instead, options.smtPath or else
+// options.fallbackPath, so solves that run at the same time need fallback paths of their own. A solver stopped through
+// cancellation counts as a failure.
+bool solveRuleSystem(const RuleSystem& system, const Options& options, bool removal, SolverResult& result, GenerationStatistics& statistics, SolverCancellation* cancellation = nullptr) {
+    std::ofstream tee;
+    if (!options.smtPath.empty()) {
+        tee.open(options.smtPath);
+    }
 
-    FILE* pipe = popen(command.str().c_str(), "r");
-    if (!pipe) {
-        return false;
+    SolverProcess solver;
+    if (!solver.start(solverProgram, { "-in" })) {
+        std::string smtPath = options.smtPath.empty() ? options.fallbackPath : options.smtPath;
+        tee.close();
+        std::ofstream smtFile(smtPath);
+        if (!smtFile.is_open()) {
+            return false;
+        }
+        statistics = writeConstraints(smtFile, system, options, removal);
+        smtFile.close();
+        return executeSMTSolver(smtPath, result);
+    }
+
+    bool answered = false;
+    if (cancellation == nullptr || cancellation->attach(solver)) {
+        SolverStreamBuffer buffer(solver, tee.is_open() ? &tee : nullptr);
+        std::ostream input(&buffer);
+        statistics = writeConstraints(input, system, options, removal);
+        input.flush();
+        answered = input && solver.request("", result);
+        if (cancellation != nullptr) {
+            cancellation->detach(solver);
+        }
     }
+    return answered;
+}
+
+// Solves the system and its mirror image together. Both terminate or neither does, but interpretations compose the
+// letters of a word from right to left, so the two give different constraints and one is often much easier. The first
+// sat answer stops the other solver through cancellation; without one the answer for the original system is kept.
+// reversed tells which of the two result belongs to.
+bool raceRuleSystems(const RuleSystem& system, const Options& options, SolverResult& result, GenerationStatistics& statistics, bool& reversed, SolverCancellation& cancellation) {
+    const RuleSystem systems[2] = { system, reverseRuleSystem(system) };
+    Options mirrorOptions = options;
+    mirrorOptions.verbose = false;
+    mirrorOptions.fallbackPath = options.fallbackPath + ".reversed";
+    if (!options.smtPath.empty()) {
+        mirrorOptions.smtPath = options.smtPath + ".reversed";
+    }
+
+    SolverResult results[2];
+    GenerationStatistics sideStatistics[2];
+    bool solved[2] = { false, false };
+    std::atomic<int> winner(-1);
+    auto solve = [&](int side) {
+        solved[side] = solveRuleSystem(systems[side], side == 0 ? options : mirrorOptions, false, results[side], sideStatistics[side], &cancellation);
+        int none = -1;
+        if (solved[side] && results[side].verdict == Verdict::Sat && winner.compare_exchange_strong(none, side)) {
+            cancellation.cancel();
+        }
+    };
+    std::thread mirror(solve, 1);
+    solve(0);
+    mirror.join();
+
+    int side = std::max(winner.load(), 0);
+    reversed = side == 1;
+    result = results[side];
+    statistics = sideStatistics[side];
+    return solved[side];
+}
 
-    char buffer[128];
-    while (!feof(pipe)) {
-        if (fgets(buffer, 128, pipe) != nullptr) {
-            output += buffer;
+// With verification set, the model behind a sat answer is checked as well and the outcome is stored there.
+Verdict checkRuleSystem(const RuleSystem& system, const Options& options, SolverCancellation* cancellation = nullptr, Verification* verification = nullptr) {
+    if (options.engine == Engine::Matrix && options.searchBound > 0) {
+        Model model;
+        if (searchMatrixInterpretation(system, options.dimension, options.searchBound, matrixSearchLimit, model)) {
+            if (verification != nullptr) {
+                *verification = verifySolution(system, options, model, false);
+            }
+            return Verdict::Sat;
         }
     }
 
-    pclose(pipe);
+    SolverResult result;
+    GenerationStatistics statistics;
+    bool solved;
+    bool reversed = false;
+    if (options.raceReversed) {
+        SolverCancellation race;
+        solved = raceRuleSystems(system, options, result, statistics, reversed, cancellation != nullptr ? *cancellation : race);
+    } else {
+        solved = solveRuleSystem(system, options, false, result, statistics, cancellation);
+    }
+    if (!solved) {
+        return Verdict::None;
+    }
+    if (verification != nullptr && result.verdict == Verdict::Sat) {
+        *verification = verifySolution(system, options, result.model, reversed);
+    }
+    return result.verdict;
+}
+
+// Each round asks for an interpretation that decreases every remaining rule weakly and at least one strictly, then
+// drops the strictly decreasing rules. The models of all rounds together prove termination.
+void removeRules(const RuleSystem& system, const Options& options) {
+    RuleSystem remaining = system;
+    for (int round = 1; !remaining.rules.empty(); round++) {
+        SolverResult result;
+        GenerationStatistics statistics;
+        if (!solveRuleSystem(remaining, options, true, result, statistics)) {
+            std::cout << "Failed to execute the Z3 solver." << std::endl;
+            return;
+        }
 
-    return true;
+        std::vector<size_t> removed;
+        for (size_t i = 0; i < remaining.rules.size(); i++) {
+            auto value = result.model.values.find("strict" + std::to_string(i));
+            if (value != result.model.values.end() && value->second != 0) {
+                removed.push_back(i);
+            }
+        }
+        if (result.verdict != Verdict::Sat || removed.empty()) {
+            std::cout << "Round " << round << ": no interpretation removes any of the " << remaining.rules.size() << " remaining rules";
+            std::cout << (result.verdict == Verdict::Unsat ? " (unsat)." : ".") << std::endl;
+            printSolverErrors(result);
+            for (const auto& rule : remaining.rules) {
+                std::cout << "  " << rule.first << " -> " << rule.second << std::endl;
+            }
+            return;
+        }
+
+        // The rules that stay only have to decrease weakly; the round is only accepted when the model checks out.
+        std::vector<bool> weak(remaining.rules.size(), true);
+        for (size_t i : removed) {
+            weak[i] = false;
+        }
+        Verification verification = options.engine == Engine::Matrix ? verifyMatrixModel(remaining, result.model, options.dimension, weak)
+                                                                      : verifyModel(remaining, result.model, std::max(options.degree, 1), weak);
+        if (!verification.failed.empty() || !verification.inconclusive.empty()) {
+            std::cout << "Round " << round << ": the model of the solver could not be confirmed." << std::endl;
+            reportVerification(remaining, verification);
+            return;
+        }
+
+        std::cout << "Round " << round << ": removed " << removed.size() << " of " << remaining.rules.size() << " rules." << std::endl;
+        Model interpretation = result.model;
+        interpretation.values.clear();
+        printModel(interpretation);
+        for (size_t i : removed) {
+            std::cout << "  " << remaining.rules[i].first << " -> " << remaining.rules[i].second << std::endl;
+        }
+        for (size_t i = removed.size(); i-- > 0;) {
+            remaining.rules.erase(remaining.rules.begin() + removed[i]);
+        }
+    }
+    std::cout << "All rules removed, the system terminates." << std::endl;
+}
+
+// Runs work on one thread per core, but on no more threads than there are tasks.
+template <typename Work>
+void runOnCores(size_t tasks, Work work) {
+    size_t count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), tasks);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count; i++) {
+        threads.emplace_back(work);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
 }
 
-void generateSMT() {
+#include "RulePrecheck.h"
+#include "LoopFinder.h"
+
+void generateSMT(const Options& options) {
     std::fstream testFile;
-    std::ofstream smtFile;
-    std::vector<char> symbols = {};
+    RuleSystem system;
     testFile.open("test.txt", std::ios::in);
-    smtFile.open("inequalities.smt2");
-    if (smtFile.is_open()) {
-        smtFile << "(set-logic QF_NIA)" << std::endl;
-        if (testFile.is_open()) {
-            std::string line;
-            while (std::getline(testFile, line)) {
-                std::pair<std::string, std::string> sides = parseInput(line);
-                std::pair<Node*, Node*>* functions = generateLinearFunctions(sides.first, sides.second);
-                std::cout << functions->first->to_string() << std::endl;
-                std::cout << functions->second->to_string() << std::endl;
-                std::map<std::pair<int, bool>, std::string> lhs = extractCoefficients(functions->first);
-                std::map<std::pair<int, bool>, std::string> rhs = extractCoefficients(functions->second);
-                generateRequirements(smtFile, symbols, sides, lhs, rhs);
+    if (testFile.is_open()) {
+        system = readRuleSystem(testFile);
+    }
+    testFile.close();
+
+    for (const auto& line : system.malformed) {
+        std::cout << "Malformed rule: " << line << std::endl;
+    }
+    if (!system.malformed.empty()) {
+        return;
+    }
+
+    std::string reason;
+    size_t hopeless = findHopelessRule(system, options, options.precheck, reason);
+    if (hopeless < system.rules.size()) {
+        std::cout << "Rule " << system.rules[hopeless].first << " -> " << system.rules[hopeless].second << " cannot be oriented: " << reason << "." << std::endl;
+        return;
+    }
+
+    if (options.ruleRemoval) {
+        removeRules(system, options);
+        return;
+    }
+
+    if (options.engine == Engine::Matrix && options.searchBound > 0) {
+        Model model;
+        if (searchMatrixInterpretation(system, options.dimension, options.searchBound, matrixSearchLimit, model)) {
+            std::cout << "Found a matrix interpretation with entries up to " << options.searchBound << "." << std::endl;
+            printModel(model);
+            return;
+        }
+        std::cout << "No matrix interpretation with entries up to " << options.searchBound << ", calling the solver." << std::endl;
+    }
+
+    // The loop finder stops the solver as soon as it finds a loop. Without a proof from the solver a loop can still
+    // settle the question, so the finder is then waited for until it has searched loopSearchStates words per rule or
+    // options.loopStates words in total.
+    std::atomic<bool> stopLoops(false);
+    SolverCancellation cancellation;
+    LoopWitness witness;
+    bool looping = false;
+    std::thread loopFinder;
+    if (options.findLoops) {
+        loopFinder = std::thread([&]() {
+            if (findLoop(system, stopLoops, options.loopStates, witness)) {
+                looping = true;
+                cancellation.cancel();
             }
+        });
+    }
+
+    GenerationStatistics statistics;
+    SolverResult result;
+    bool reversed = false;
+    bool solved;
+    if (options.raceReversed) {
+        solved = raceRuleSystems(system, options, result, statistics, reversed, cancellation);
+    } else {
+        solved = solveRuleSystem(system, options, false, result, statistics, &cancellation);
+    }
+    bool proved = solved && result.verdict == Verdict::Sat;
+    if (loopFinder.joinable()) {
+        if (proved) {
+            stopLoops = true;
+        } else if (!stopLoops) {
+            std::cout << "The solver found no interpretation, waiting for the loop search to finish (at most " << options.loopStates << " words)." << std::endl;
+        }
+        loopFinder.join();
+    }
+    if (looping) {
+        printLoop(system, witness);
+        if (!proved) {
+            return;
         }
-        testFile.close();
-        smtFile << "(check-sat)" << std::endl;
-        smtFile << "(get-model)" << std::endl;
+        std::cout << "Warning: the solver also reports an interpretation (sat), which contradicts the loop above." << std::endl;
     }
-    smtFile.close();
 
-    std::string solverOutput;
-    if (executeSMTSolver("inequalities.smt2", solverOutput)) {
-        if (solverOutput.find("unsat") != std::string::npos) {
-            std::cout << "The inequalities are unsatisfiable (unsat)." << std::endl;
-        } else if (solverOutput.find("sat") != std::string::npos) {
-            std::cout << "The inequalities are satisfiable (sat)." << std::endl;
+    std::cout << "Rules: " << system.rules.size() << " distinct, " << system.duplicateRules << " shared; "
+              << "words: " << statistics.words << " distinct, " << statistics.sharedWords << " shared; "
+              << "constraints: " << statistics.constraints << " distinct, " << statistics.sharedConstraints << " shared." << std::endl;
 
-            std::istringstream iss(solverOutput);
-            std::string line;
-            while (std::getline(iss, line)) {
-                std::cout << line << std::endl;
-            }
+    std::string orientation = !options.raceReversed ? "" : reversed ? " for the reversed rules" : " for the original rules";
+    if (solved) {
+        if (result.verdict == Verdict::Unsat) {
+            std::cout << "The inequalities" << orientation << " are unsatisfiable (unsat)." << std::endl;
+        } else if (result.verdict == Verdict::Sat) {
+            std::cout << "The inequalities" << orientation << " are satisfiable (sat)." << std::endl;
+            printModel(result.model);
+            reportVerification(reversed ? reverseRuleSystem(system) : system, verifySolution(system, options, result.model, reversed));
         } else {
             std::cout << "Unable to determine the result." << std::endl;
         }
     } else {
         std::cout << "Failed to execute the Z3 solver." << std::endl;
     }
+    printSolverErrors(result);
 }
 
+#include "ShardedRunner.h"
+
 #endif //FLT1_SMTGENERATION_H
@@ -0,0 +1,584 @@
+#ifndef FLT1_SHARDEDRUNNER_H
+#define FLT1_SHARDEDRUNNER_H
+
+// The coordinator splits a corpus of rule systems into shards and hands them to worker processes over TCP, so
+// workers may run locally (started by the coordinator) or on other hosts (started with --worker HOST:PORT).
+// Every message is a text line; rule systems are sent with their length so that they can contain anything:
+//   worker -> coordinator: HELLO <pid>, RESULT <index> <verdict>
+//   coordinator -> worker: SYSTEM <index> <bytes> followed by the file contents, EXIT
+// A worker answers the systems of its shard in order, so the first unanswered one is the one it is working on.
+// When a worker disconnects or exceeds the timeout, that system is retried alone and the rest of the shard is
+// requeued; a system that brings down maximumAttempts workers is reported as crashed.
+std::string verdictName(Verdict verdict) {
+    switch (verdict) {
+        case Verdict::Sat:
+            return "sat";
+        case Verdict::Unsat:
+            return "unsat";
+        case Verdict::Unknown:
+            return "unknown";
+        default:
+            return "error";
+    }
+}
+
+// A sat answer whose model does not orient every rule, or cannot be checked because of overflow, is no proof.
+std::string checkedVerdictName(const RuleSystem& system, const Options& options) {
+    Verification verification;
+    Verdict verdict = checkRuleSystem(system, options, nullptr, &verification);
+    if (verdict == Verdict::Sat && (!verification.failed.empty() || !verification.inconclusive.empty())) {
+        return "unverified";
+    }
+    return verdictName(verdict);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+const int maximumAttempts = 3;
+
+bool splitAddress(const std::string& address, std::string& host, std::string& port) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon + 1 == address.size()) {
+        return false;
+    }
+    host = address.substr(0, colon);
+    port = address.substr(colon + 1);
+    return true;
+}
+
+int connectTo(const std::string& address) {
+    std::string host, port;
+    if (!splitAddress(address, host, port)) {
+        return -1;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+
+    int connection = -1;
+    for (addrinfo* candidate = addresses; candidate != nullptr && connection < 0; candidate = candidate->ai_next) {
+        connection = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (connection >= 0 && connect(connection, candidate->ai_addr, candidate->ai_addrlen) != 0) {
+            close(connection);
+            connection = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    return connection;
+}
+
+// Returns the listening socket and stores the address local workers should connect to in localAddress.
+int listenOn(const std::string& address, std::string& localAddress) {
+    std::string host, port;
+    if (!splitAddress(address, host, port)) {
+        return -1;
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+
+    int listener = -1;
+    for (addrinfo* candidate = addresses; candidate != nullptr && listener < 0; candidate = candidate->ai_next) {
+        listener = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        int reuse = 1;
+        if (listener >= 0 && (setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+                              || bind(listener, candidate->ai_addr, candidate->ai_addrlen) != 0
+                              || ::listen(listener, 64) != 0)) {
+            close(listener);
+            listener = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (listener < 0) {
+        return -1;
+    }
+
+    sockaddr_in bound = {};
+    socklen_t length = sizeof(bound);
+    getsockname(listener, reinterpret_cast<sockaddr*>(&bound), &length);
+    fcntl(listener, F_SETFD, FD_CLOEXEC);
+    localAddress = (host.empty() || host == "0.0.0.0" ? std::string("127.0.0.1") : host) + ":" + std::to_string(ntohs(bound.sin_port));
+    return listener;
+}
+
+bool sendAll(int connection, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t count = send(connection, data.data() + sent, data.size() - sent, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        sent += count;
+    }
+    return true;
+}
+
+bool receiveMore(int connection, std::string& buffer) {
+    std::vector<char> chunk(1 << 16);
+    ssize_t count;
+    do {
+        count = recv(connection, chunk.data(), chunk.size(), 0);
+    } while (count < 0 && errno == EINTR);
+    if (count <= 0) {
+        return false;
+    }
+    buffer.append(chunk.data(), count);
+    return true;
+}
+
+bool readLine(int connection, std::string& buffer, std::string& line) {
+    size_t newline;
+    while ((newline = buffer.find('\n')) == std::string::npos) {
+        if (!receiveMore(connection, buffer)) {
+            return false;
+        }
+    }
+    line = buffer.substr(0, newline);
+    buffer.erase(0, newline + 1);
+    return true;
+}
+
+bool readBytes(int connection, std::string& buffer, size_t count, std::string& data) {
+    while (buffer.size() < count) {
+        if (!receiveMore(connection, buffer)) {
+            return false;
+        }
+    }
+    data = buffer.substr(0, count);
+    buffer.erase(0, count);
+    return true;
+}
+
+bool runWorker(const Options& options) {
+    signal(SIGPIPE, SIG_IGN);
+    int connection = connectTo(options.worker);
+    if (connection < 0) {
+        std::cout << "Unable to connect to " << options.worker << "." << std::endl;
+        return false;
+    }
+
+    // The workers share the working directory, so a solver that cannot be started must not send them all to one file.
+    Options workerOptions = options;
+    workerOptions.fallbackPath = "inequalities" + std::to_string(getpid()) + ".smt2";
+
+    std::string buffer;
+    std::string line;
+    bool connected = sendAll(connection, "HELLO " + std::to_string(getpid()) + "\n");
+    while (connected && readLine(connection, buffer, line)) {
+        std::istringstream message(line);
+        std::string command;
+        size_t index = 0;
+        size_t length = 0;
+        std::string contents;
+        message >> command;
+        if (command == "EXIT") {
+            break;
+        }
+        if (command != "SYSTEM" || !(message >> index >> length) || !readBytes(connection, buffer, length, contents)) {
+            connected = false;
+            break;
+        }
+
+        std::istringstream input(contents);
+        RuleSystem system = readRuleSystem(input);
+        std::string verdict = system.malformed.empty() ? checkedVerdictName(system, workerOptions) : "malformed";
+        connected = sendAll(connection, "RESULT " + std::to_string(index) + " " + verdict + "\n");
+    }
+
+    close(connection);
+    return connected;
+}
+
+class WorkerConnection {
+public:
+    int descriptor = -1;
+    pid_t pid = 0;
+    bool ready = false;
+    std::string input;
+    std::string output;
+    std::deque<size_t> assigned;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+class ShardCoordinator {
+public:
+    std::vector<std::string> paths;
+    std::vector<std::string> verdicts;
+
+    ShardCoordinator(const Options& options, const std::string& program) : options(options), program(program) {}
+
+    bool load() {
+        std::ifstream corpus(options.corpus);
+        if (!corpus.is_open()) {
+            return false;
+        }
+        std::string line;
+        while (std::getline(corpus, line)) {
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            line.erase(0, line.find_first_not_of(" \t"));
+            if (!line.empty()) {
+                paths.push_back(line);
+            }
+        }
+
+        verdicts.assign(paths.size(), "");
+        attempts.assign(paths.size(), 0);
+        for (size_t i = 0; i < paths.size(); i += options.shardSize) {
+            std::vector<size_t> shard;
+            for (size_t j = i; j < paths.size() && j < i + options.shardSize; j++) {
+                shard.push_back(j);
+            }
+            shards.push_back(shard);
+        }
+        return true;
+    }
+
+    bool run() {
+        signal(SIGPIPE, SIG_IGN);
+        listener = listenOn(options.listen, address);
+        if (listener < 0) {
+            return false;
+        }
+        std::cerr << "Listening for workers on " << address << std::endl;
+
+        int workers = options.workers >= 0 ? options.workers : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        size_t spawnBudget = workers + maximumAttempts * paths.size();
+
+        while (completed < paths.size()) {
+            reap();
+            while (static_cast<int>(children.size()) < workers && spawnBudget > 0 && spawn()) {
+                spawnBudget--;
+            }
+            if (workers > 0 && children.empty() && connections.empty() && spawnBudget == 0) {
+                abandon();
+                break;
+            }
+
+            for (auto& connection : connections) {
+                if (connection.ready && connection.assigned.empty()) {
+                    assign(connection);
+                }
+            }
+
+            std::vector<pollfd> descriptors(connections.size() + 1);
+            descriptors[0] = { listener, POLLIN, 0 };
+            for (size_t i = 0; i < connections.size(); i++) {
+                descriptors[i + 1] = { connections[i].descriptor, static_cast<short>(connections[i].output.empty() ? POLLIN : POLLIN | POLLOUT), 0 };
+            }
+            if (poll(descriptors.data(), descriptors.size(), 100) < 0 && errno != EINTR) {
+                break;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            for (size_t i = connections.size(); i-- > 0;) {
+                WorkerConnection& connection = connections[i];
+                short events = descriptors[i + 1].revents;
+                bool alive = true;
+                if (events & (POLLIN | POLLHUP | POLLERR)) {
+                    alive = receive(connection);
+                }
+                if (alive && (events & POLLOUT)) {
+                    alive = flush(connection);
+                }
+                if (alive && !connection.assigned.empty() && now > connection.deadline) {
+                    std::cerr << "Worker " << connection.pid << " timed out on " << paths[connection.assigned.front()] << std::endl;
+                    alive = false;
+                } else if (alive && !connection.ready && now > connection.deadline) {
+                    std::cerr << "A worker connected but did not introduce itself in time." << std::endl;
+                    alive = false;
+                }
+                if (!alive) {
+                    lose(connection);
+                    connections.erase(connections.begin() + i);
+                }
+            }
+
+            if (descriptors[0].revents & POLLIN) {
+                accept();
+            }
+            abortSilentChildren(now);
+        }
+
+        for (auto& connection : connections) {
+            fcntl(connection.descriptor, F_SETFL, fcntl(connection.descriptor, F_GETFL) & ~O_NONBLOCK);
+            sendAll(connection.descriptor, connection.output + "EXIT\n");
+            close(connection.descriptor);
+        }
+        connections.clear();
+        close(listener);
+        while (!children.empty()) {
+            pid_t child = children.begin()->first;
+            siginfo_t info;
+            while (waitid(P_PID, child, &info, WEXITED | WNOWAIT) != 0 && errno == EINTR) {
+            }
+            forget(child);
+        }
+        return completed == paths.size();
+    }
+
+    void report(std::ostream& os) const {
+        for (size_t i = 0; i < paths.size(); i++) {
+            os << paths[i] << ": " << (verdicts[i].empty() ? "unfinished" : verdicts[i]) << std::endl;
+        }
+    }
+
+private:
+    const Options& options;
+    std::string program;
+    std::string address;
+    int listener = -1;
+    size_t completed = 0;
+    std::vector<int> attempts;
+    std::deque<std::vector<size_t>> shards;
+    std::vector<WorkerConnection> connections;
+    // Local workers with the time by which they have to introduce themselves with HELLO.
+    std::map<pid_t, std::chrono::steady_clock::time_point> children;
+
+    void complete(size_t index, const std::string& verdict) {
+        if (verdicts[index].empty()) {
+            verdicts[index] = verdict;
+            completed++;
+        }
+    }
+
+    bool spawn() {
+        std::vector<std::string> arguments = { program, "--worker", address,
+                                               "--engine", options.engine == Engine::Matrix ? "matrix" : "ordinal",
+                                               "--dimension", std::to_string(options.dimension) };
+        if (options.degree > 0) {
+            arguments.push_back("--degree");
+            arguments.push_back(std::to_string(options.degree));
+        }
+        if (options.searchBound > 0) {
+            arguments.push_back("--search");
+            arguments.push_back(std::to_string(options.searchBound));
+        }
+        if (options.raceReversed) {
+            arguments.push_back("--reversed");
+        }
+        std::vector<char*> argv;
+        for (auto& argument : arguments) {
+            argv.push_back(&argument[0]);
+        }
+        argv.push_back(nullptr);
+
+        // Each worker leads its own process group, so killing a hung worker also stops the solver it started.
+        pid_t child = fork();
+        if (child < 0) {
+            return false;
+        }
+        if (child == 0) {
+            setpgid(0, 0);
+            execv(program.c_str(), argv.data());
+            _exit(127);
+        }
+        setpgid(child, child);
+        children[child] = std::chrono::steady_clock::now() + std::chrono::seconds(options.timeout);
+        return true;
+    }
+
+    // Exited workers are only looked at here and reaped by forget, after their process group has been killed.
+    void reap() {
+        siginfo_t info;
+        info.si_pid = 0;
+        while (waitid(P_ALL, 0, &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid != 0) {
+            forget(info.si_pid);
+            info.si_pid = 0;
+        }
+    }
+
+    // A worker that died may leave its solver behind. While the worker is not reaped its pid, which is also the id of
+    // its process group, cannot be reused, so the kill reaches only its own processes.
+    void forget(pid_t child) {
+        kill(-child, SIGKILL);
+        waitpid(child, nullptr, 0);
+        children.erase(child);
+    }
+
+    // Kills local workers that have not said HELLO in time; reap then forgets them like any other dead worker.
+    void abortSilentChildren(std::chrono::steady_clock::time_point now) {
+        for (auto& child : children) {
+            bool introduced = std::any_of(connections.begin(), connections.end(), [&child](const WorkerConnection& connection) {
+                return connection.pid == child.first;
+            });
+            if (!introduced && now > child.second) {
+                std::cerr << "Worker " << child.first << " did not connect in time" << std::endl;
+                kill(-child.first, SIGKILL);
+                child.second = std::chrono::steady_clock::time_point::max();
+            }
+        }
+    }
+
+    void accept() {
+        int descriptor = ::accept(listener, nullptr, nullptr);
+        if (descriptor < 0) {
+            return;
+        }
+        fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL) | O_NONBLOCK);
+        fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+        WorkerConnection connection;
+        connection.descriptor = descriptor;
+        connection.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.timeout);
+        connections.push_back(std::move(connection));
+    }
+
+    void assign(WorkerConnection& connection) {
+        while (connection.assigned.empty() && !shards.empty()) {
+            std::vector<size_t> shard = std::move(shards.front());
+            shards.pop_front();
+            for (size_t index : shard) {
+                std::ifstream file(paths[index]);
+                if (!file.is_open()) {
+                    complete(index, "unreadable");
+                    continue;
+                }
+                std::stringstream contents;
+                contents << file.rdbuf();
+                connection.output += "SYSTEM " + std::to_string(index) + " " + std::to_string(contents.str().size()) + "\n" + contents.str();
+                connection.assigned.push_back(index);
+            }
+        }
+        connection.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.timeout);
+    }
+
+    bool flush(WorkerConnection& connection) {
+        ssize_t count = send(connection.descriptor, connection.output.data(), connection.output.size(), 0);
+        if (count < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        connection.output.erase(0, count);
+        return true;
+    }
+
+    bool receive(WorkerConnection& connection) {
+        char chunk[4096];
+        ssize_t count = recv(connection.descriptor, chunk, sizeof(chunk), 0);
+        if (count < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        if (count == 0) {
+            return false;
+        }
+        connection.input.append(chunk, count);
+
+        size_t newline;
+        while ((newline = connection.input.find('\n')) != std::string::npos) {
+            std::string line = connection.input.substr(0, newline);
+            connection.input.erase(0, newline + 1);
+            if (!handle(connection, line)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool handle(WorkerConnection& connection, const std::string& line) {
+        std::istringstream message(line);
+        std::string command;
+        message >> command;
+
+        if (command == "HELLO") {
+            long pid = 0;
+            message >> pid;
+            bool claimed = std::any_of(connections.begin(), connections.end(), [pid](const WorkerConnection& other) {
+                return other.pid == pid;
+            });
+            if (children.count(pid) != 0 && !claimed) {
+                connection.pid = pid;
+            }
+            connection.ready = true;
+            return true;
+        }
+
+        size_t index = 0;
+        std::string verdict;
+        if (command != "RESULT" || !(message >> index >> verdict) || connection.assigned.empty() || connection.assigned.front() != index) {
+            return false;
+        }
+        connection.assigned.pop_front();
+        complete(index, verdict);
+        connection.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.timeout);
+        return true;
+    }
+
+    void lose(WorkerConnection& connection) {
+        if (connection.pid != 0 && children.count(connection.pid) != 0) {
+            kill(-connection.pid, SIGKILL);
+        }
+        close(connection.descriptor);
+        if (connection.assigned.empty()) {
+            return;
+        }
+
+        size_t failing = connection.assigned.front();
+        connection.assigned.pop_front();
+        if (!connection.assigned.empty()) {
+            shards.emplace_front(connection.assigned.begin(), connection.assigned.end());
+        }
+        if (++attempts[failing] >= maximumAttempts) {
+            complete(failing, "crashed");
+        } else {
+            shards.push_front({ failing });
+        }
+    }
+
+    void abandon() {
+        std::cerr << "No workers left." << std::endl;
+        for (const auto& shard : shards) {
+            for (size_t index : shard) {
+                complete(index, "crashed");
+            }
+        }
+        shards.clear();
+    }
+};
+
+bool runCoordinator(const Options& options, const char* program) {
+#if defined(__linux__)
+    (void) program;
+    ShardCoordinator coordinator(options, "/proc/self/exe");
+#else
+    ShardCoordinator coordinator(options, program);
+#endif
+    if (!coordinator.load()) {
+        std::cout << "Unable to read the corpus " << options.corpus << "." << std::endl;
+        return false;
+    }
+    if (!coordinator.run()) {
+        coordinator.report(std::cout);
+        std::cout << "The run did not finish." << std::endl;
+        return false;
+    }
+    coordinator.report(std::cout);
+    return true;
+}
+
+#else
+
+bool runWorker(const Options&) {
+    std::cout << "Workers are only supported on POSIX systems." << std::endl;
+    return false;
+}
+
+bool runCoordinator(const Options&, const char*) {
+    std::cout << "Sharded runs are only supported on POSIX systems." << std::endl;
+    return false;
+}
+
+#endif
+
+#endif //FLT1_SHARDEDRUNNER_H
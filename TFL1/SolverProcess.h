@@ -0,0 +1,328 @@
+#ifndef FLT1_SOLVERPROCESS_H
+#define FLT1_SOLVERPROCESS_H
+
+// A solver reading commands from its stdin that stays alive between queries. Every request ends with an echo of
+// marker, so the end of the answer is known without waiting for the process to exit.
+#if defined(__unix__) || defined(__APPLE__)
+
+class SolverProcess {
+public:
+    SolverProcess() = default;
+    SolverProcess(const SolverProcess&) = delete;
+    SolverProcess& operator=(const SolverProcess&) = delete;
+    ~SolverProcess() {
+        stop();
+    }
+
+    bool running() const {
+        return pid > 0;
+    }
+
+    bool start(const std::string& program, const std::vector<std::string>& arguments) {
+        stop();
+        int toSolver[2];
+        int fromSolver[2];
+        if (!openPipe(toSolver)) {
+            return false;
+        }
+        if (!openPipe(fromSolver)) {
+            close(toSolver[0]);
+            close(toSolver[1]);
+            return false;
+        }
+        // Closed on a successful exec; otherwise the child writes errno into it, so a missing solver is noticed here.
+        int status[2];
+        if (!openPipe(status)) {
+            for (int descriptor : { toSolver[0], toSolver[1], fromSolver[0], fromSolver[1] }) {
+                close(descriptor);
+            }
+            return false;
+        }
+
+        std::vector<std::string> command = arguments;
+        command.insert(command.begin(), program);
+        std::vector<char*> argv;
+        for (auto& argument : command) {
+            argv.push_back(&argument[0]);
+        }
+        argv.push_back(nullptr);
+
+        pid_t child = fork();
+        if (child < 0) {
+            for (int descriptor : { toSolver[0], toSolver[1], fromSolver[0], fromSolver[1], status[0], status[1] }) {
+                close(descriptor);
+            }
+            return false;
+        }
+        if (child == 0) {
+            dup2(toSolver[0], STDIN_FILENO);
+            dup2(fromSolver[1], STDOUT_FILENO);
+            for (int descriptor : { toSolver[0], toSolver[1], fromSolver[0], fromSolver[1], status[0] }) {
+                close(descriptor);
+            }
+            execvp(program.c_str(), argv.data());
+            int error = errno;
+            ssize_t ignored = write(status[1], &error, sizeof(error));
+            (void) ignored;
+            _exit(127);
+        }
+
+        close(toSolver[0]);
+        close(fromSolver[1]);
+        close(status[1]);
+        int error = 0;
+        ssize_t count;
+        do {
+            count = read(status[0], &error, sizeof(error));
+        } while (count < 0 && errno == EINTR);
+        close(status[0]);
+        if (count > 0) {
+            close(toSolver[1]);
+            close(fromSolver[0]);
+            waitpid(child, nullptr, 0);
+            errno = error;
+            return false;
+        }
+        pid = child;
+        input = toSolver[1];
+        output = fromSolver[0];
+        fcntl(input, F_SETFL, fcntl(input, F_GETFL) | O_NONBLOCK);
+        return true;
+    }
+
+    // SIGPIPE is blocked while writing, so a solver that died shows up as a failed write instead of killing us. The
+    // solver may answer before it has read everything, an error for every bad command for instance, so its output is
+    // collected for receive() while writing; otherwise both sides could block on full pipes.
+    bool send(const std::string& commands) {
+        return send(commands.data(), commands.size());
+    }
+
+    bool send(const char* commands, size_t size) {
+        if (!running()) {
+            return false;
+        }
+        sigset_t pipeSignal;
+        sigset_t previous;
+        sigemptyset(&pipeSignal);
+        sigaddset(&pipeSignal, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipeSignal, &previous);
+
+        bool written = true;
+        bool readable = true;
+        char chunk[1 << 12];
+        for (size_t sent = 0; sent < size;) {
+            pollfd descriptors[2] = { { input, POLLOUT, 0 }, { readable ? output : -1, POLLIN, 0 } };
+            if (poll(descriptors, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                written = false;
+                break;
+            }
+            if (descriptors[1].revents != 0) {
+                ssize_t count = read(output, chunk, sizeof(chunk));
+                if (count > 0) {
+                    unread.append(chunk, count);
+                } else if (count == 0 || errno != EINTR) {
+                    readable = false;
+                }
+            }
+            if (descriptors[0].revents != 0) {
+                ssize_t count = write(input, commands + sent, size - sent);
+                if (count < 0 && (errno == EINTR || errno == EAGAIN)) {
+                    continue;
+                }
+                if (count <= 0) {
+                    written = false;
+                    break;
+                }
+                sent += count;
+            }
+        }
+
+        sigset_t pending;
+        sigpending(&pending);
+        if (!written && sigismember(&pending, SIGPIPE)) {
+            int received;
+            sigwait(&pipeSignal, &received);
+        }
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        return written;
+    }
+
+    bool request(const std::string& commands, SolverResult& result) {
+        if (!send(commands + "(echo \"" + marker + "\")\n")) {
+            return false;
+        }
+        return receive(result);
+    }
+
+    bool receive(SolverResult& result) {
+        SExpressionReader reader(result);
+        reader.expect(marker);
+        reader.feed(unread.data(), unread.size());
+        unread.clear();
+        std::vector<char> buffer(1 << 16);
+        while (!reader.reached()) {
+            ssize_t count = read(output, buffer.data(), buffer.size());
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            reader.feed(buffer.data(), count);
+        }
+        return true;
+    }
+
+    // Safe to call from another thread while this one waits for an answer, which then fails.
+    void interrupt() {
+        if (running()) {
+            kill(pid, SIGKILL);
+        }
+    }
+
+    void stop() {
+        if (!running()) {
+            return;
+        }
+        close(input);
+        close(output);
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        pid = -1;
+        unread.clear();
+    }
+
+private:
+    const std::string marker = "tfl1-done";
+    pid_t pid = -1;
+    int input = -1;
+    int output = -1;
+    std::string unread;
+
+    // Both ends are closed on exec, so solvers started from other threads do not keep this pipe open.
+    static bool openPipe(int descriptors[2]) {
+#if defined(__linux__)
+        return pipe2(descriptors, O_CLOEXEC) == 0;
+#else
+        if (pipe(descriptors) != 0) {
+            return false;
+        }
+        fcntl(descriptors[0], F_SETFD, FD_CLOEXEC);
+        fcntl(descriptors[1], F_SETFD, FD_CLOEXEC);
+        return true;
+#endif
+    }
+};
+
+#else
+
+class SolverProcess {
+public:
+    bool running() const {
+        return false;
+    }
+
+    bool start(const std::string&, const std::vector<std::string>&) {
+        return false;
+    }
+
+    bool send(const std::string&) {
+        return false;
+    }
+
+    bool send(const char*, size_t) {
+        return false;
+    }
+
+    bool request(const std::string&, SolverResult&) {
+        return false;
+    }
+
+    void interrupt() {}
+
+    void stop() {}
+};
+
+#endif
+
+// Lets another thread stop the solvers searches are waiting for. After cancel() no solver can be attached any more.
+class SolverCancellation {
+public:
+    bool attach(SolverProcess& process) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled) {
+            return false;
+        }
+        solvers.push_back(&process);
+        return true;
+    }
+
+    void detach(SolverProcess& process) {
+        std::lock_guard<std::mutex> lock(mutex);
+        solvers.erase(std::remove(solvers.begin(), solvers.end(), &process), solvers.end());
+    }
+
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        for (SolverProcess* solver : solvers) {
+            solver->interrupt();
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<SolverProcess*> solvers;
+    bool cancelled = false;
+};
+
+// Collects the writes to an std::ostream in a large buffer and passes them to the solver, and to tee when it is given,
+// only when the buffer is full or the stream is flushed.
+class SolverStreamBuffer : public std::streambuf {
+public:
+    SolverStreamBuffer(SolverProcess& solver, std::ostream* tee, size_t size = 1 << 20) : solver(solver), tee(tee), buffer(size) {
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    ~SolverStreamBuffer() override {
+        sync();
+    }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    // A failed write puts the stream into a bad state, so that generation can stop early.
+    int sync() override {
+        std::ptrdiff_t size = pptr() - pbase();
+        if (size > 0) {
+            if (tee != nullptr) {
+                tee->write(pbase(), size);
+            }
+            bool sent = solver.send(pbase(), size);
+            setp(buffer.data(), buffer.data() + buffer.size());
+            if (!sent) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+private:
+    SolverProcess& solver;
+    std::ostream* tee;
+    std::vector<char> buffer;
+};
+
+#endif //FLT1_SOLVERPROCESS_H
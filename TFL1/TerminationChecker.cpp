@@ -0,0 +1,101 @@
+#include "TerminationChecker.h"
+#include "ConstraintGeneration.h"
+
+class TerminationChecker::State {
+public:
+    CheckerSettings settings;
+    SolverProcess solver;
+    InterpretationCache interpretations;
+    MatrixEngine matrices;
+    std::vector<char> symbols;
+    std::vector<std::string> coefficientNames;
+
+    explicit State(const CheckerSettings& settings)
+        : settings(settings), interpretations(settings.degree), matrices(settings.dimension),
+          coefficientNames(templateCoefficientNames(std::max(settings.degree, 1))) {}
+
+    // Letters and word products are declared outside of the push/pop scopes, so they are only known to the solver
+    // process that received them.
+    bool startSolver() {
+        if (solver.running()) {
+            return true;
+        }
+        symbols.clear();
+        matrices = MatrixEngine(settings.dimension);
+        SolverResult ignored;
+        return solver.start(settings.solver, { "-in" }) && solver.request("(set-logic QF_NIA)\n", ignored);
+    }
+
+    CheckResult check(const RuleSystem& system) {
+        CheckResult result;
+        result.malformed = system.malformed;
+        if (!system.malformed.empty()) {
+            return result;
+        }
+
+        if (settings.matrix && settings.searchBound > 0
+            && searchMatrixInterpretation(system, settings.dimension, settings.searchBound, matrixSearchLimit, result.model)) {
+            result.verdict = Verdict::Sat;
+            return result;
+        }
+
+        if (!startSolver()) {
+            solver.stop();
+            result.errors.push_back("Failed to start " + settings.solver + ".");
+            return result;
+        }
+
+        std::ostringstream declarations;
+        std::ostringstream assertions;
+        std::unordered_set<std::string> constraints;
+        for (const auto& sides : system.rules) {
+            if (settings.matrix) {
+                generateMatrixRequirements(declarations, assertions, symbols, constraints, matrices, sides);
+            } else {
+                const WordInterpretation& lhs = interpretations.get(sides.first);
+                const WordInterpretation& rhs = interpretations.get(sides.second);
+                generateRequirements(declarations, assertions, symbols, constraints, coefficientNames, sides, lhs.coefficients, rhs.coefficients);
+            }
+        }
+
+        SolverResult answer;
+        bool answered = solver.request(declarations.str() + "(push 1)\n" + assertions.str() + "(check-sat)\n", answer);
+        if (answered && answer.verdict == Verdict::Sat) {
+            answered = solver.request("(get-model)\n", answer);
+        }
+        if (!answered || !solver.send("(pop 1)\n")) {
+            solver.stop();
+            result.errors.push_back("The solver stopped responding.");
+            return result;
+        }
+
+        result.verdict = answer.verdict;
+        result.model = std::move(answer.model);
+        result.errors = std::move(answer.errors);
+        if (result.verdict == Verdict::Sat) {
+            Verification verification = settings.matrix ? verifyMatrixModel(system, result.model, settings.dimension)
+                                                        : verifyModel(system, result.model, std::max(settings.degree, 1));
+            result.failedRules = verification.failed;
+            result.inconclusiveRules = verification.inconclusive;
+        }
+        return result;
+    }
+};
+
+TerminationChecker::TerminationChecker(const CheckerSettings& settings) : state(new State(settings)) {}
+
+TerminationChecker::~TerminationChecker() = default;
+
+CheckResult TerminationChecker::check(const std::vector<std::pair<std::string, std::string>>& rules) {
+    return state->check(makeRuleSystem(rules));
+}
+
+CheckResult TerminationChecker::check(const std::string& rules) {
+    std::istringstream input(rules);
+    return state->check(readRuleSystem(input));
+}
+
+void TerminationChecker::reset() {
+    CheckerSettings settings = state->settings;
+    state.reset(new State(settings));
+}
@@ -0,0 +1,50 @@
+#ifndef FLT1_TERMINATIONCHECKER_H
+#define FLT1_TERMINATIONCHECKER_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Verdict.h"
+
+class CheckerSettings {
+public:
+    bool matrix = false;
+    int degree = 0;
+    int dimension = 2;
+    int searchBound = 0;
+    std::string solver = "z3.exe";
+};
+
+class CheckResult {
+public:
+    Verdict verdict = Verdict::None;
+    Model model;
+    std::vector<std::string> malformed;
+    std::vector<size_t> failedRules;
+    std::vector<size_t> inconclusiveRules;
+    std::vector<std::string> errors;
+};
+
+// Proves termination of rule systems given in memory. The checker keeps the interpretations of the words it has seen
+// and one solver process between calls; every call runs in its own push/pop scope and has no file or console output.
+// Verdict::None means that the solver could not be run, the reason is in errors. Use one checker per thread.
+class TerminationChecker {
+public:
+    explicit TerminationChecker(const CheckerSettings& settings = CheckerSettings());
+    ~TerminationChecker();
+    TerminationChecker(const TerminationChecker&) = delete;
+    TerminationChecker& operator=(const TerminationChecker&) = delete;
+
+    CheckResult check(const std::vector<std::pair<std::string, std::string>>& rules);
+    // rules in the format of test.txt, one "lhs -> rhs" per line
+    CheckResult check(const std::string& rules);
+    // drops the caches and restarts the solver
+    void reset();
+
+private:
+    class State;
+    std::unique_ptr<State> state;
+};
+
+#endif //FLT1_TERMINATIONCHECKER_H
@@ -0,0 +1,71 @@
+#ifndef FLT1_VERDICT_H
+#define FLT1_VERDICT_H
+
+#include <map>
+#include <set>
+#include <string>
+
+// The answer of a solver and the values it assigned, shared by the command line tool and TerminationChecker.
+enum class Verdict { None, Sat, Unsat, Unknown };
+
+class Model {
+public:
+    std::map<char, std::map<std::string, long long>> coefficients;
+    std::map<std::string, long long> values;
+    std::set<char> overflowed;
+
+    void assign(const std::string& name, long long value) {
+        if (isCoefficient(name)) {
+            coefficients[name.back()][name.substr(0, name.size() - 2)] = value;
+        } else {
+            values[name] = value;
+        }
+    }
+
+    // The value of name does not fit into a long long, so rules with its letter cannot be checked.
+    void assignOverflow(const std::string& name) {
+        if (isCoefficient(name)) {
+            overflowed.insert(name.back());
+        }
+    }
+
+    bool overflows(const std::string& word) const {
+        for (char symbol : word) {
+            if (overflowed.count(symbol) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool get(char symbol, const std::string& name, long long& value) const {
+        auto symbolIt = coefficients.find(symbol);
+        if (symbolIt == coefficients.end()) {
+            return false;
+        }
+        auto valueIt = symbolIt->second.find(name);
+        if (valueIt == symbolIt->second.end()) {
+            return false;
+        }
+        value = valueIt->second;
+        return true;
+    }
+
+    bool empty() const {
+        return coefficients.empty() && values.empty();
+    }
+
+    void clear() {
+        coefficients.clear();
+        values.clear();
+        overflowed.clear();
+    }
+
+private:
+    static bool isCoefficient(const std::string& name) {
+        size_t separator = name.find_last_of('_');
+        return separator != std::string::npos && separator > 0 && separator + 2 == name.size();
+    }
+};
+
+#endif //FLT1_VERDICT_H
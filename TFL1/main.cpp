@@ -1,7 +1,19 @@
 #include "SMTGeneration.h"
 
-int main() {
-    generateSMT();
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (!options.worker.empty()) {
+        return runWorker(options) ? 0 : 1;
+    }
+    if (!options.corpus.empty()) {
+        return runCoordinator(options, argv[0]) ? 0 : 1;
+    }
+    generateSMT(options);
 
     return 0;
 }
@@ -0,0 +1,25 @@
+#!/bin/sh
+# Stand-in for "z3 -in" used by checker_test. It answers unsat when an assertion inside the current push scope
+# mentions the letter u and sat otherwise, with d = 2 for the letter b and 1 for every other coefficient declared so
+# far. Every start and every push, with the depth it reaches, is logged to $TFL1_SOLVER_LOG.
+echo start >> "$TFL1_SOLVER_LOG"
+names=""
+depth=0
+unsat=""
+while read -r line; do
+    case "$line" in
+        *declare-fun*) set -- $line; names="$names $2" ;;
+        "(push"*) depth=$((depth + 1)); unsat=""; echo "push $depth" >> "$TFL1_SOLVER_LOG" ;;
+        "(pop"*) if [ "$depth" -eq 0 ]; then echo '(error "pop without push")'; else depth=$((depth - 1)); fi; unsat="" ;;
+        "(assert"*_u[\ \)]*) if [ "$depth" -gt 0 ]; then unsat=1; fi ;;
+        *check-sat*) if [ -n "$unsat" ]; then echo unsat; else echo sat; fi ;;
+        *get-model*)
+            echo "("
+            for name in $names; do
+                if [ "$name" = d_b ]; then value=2; else value=1; fi
+                echo "(define-fun $name () Int $value)"
+            done
+            echo ")" ;;
+        *echo*) echo tfl1-done ;;
+    esac
+done
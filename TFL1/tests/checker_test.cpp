@@ -0,0 +1,67 @@
+// Runs TerminationChecker against tests/checker_solver.sh: one solver process serves several checks, each in its own
+// push/pop scope, so an unsat answer does not leak into the next check, and reset() starts a new process.
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "TerminationChecker.h"
+
+int failures = 0;
+
+void expect(bool condition, const std::string& description) {
+    if (!condition) {
+        std::cout << "FAILED: " << description << std::endl;
+        failures++;
+    }
+}
+
+bool proved(const CheckResult& result) {
+    return result.verdict == Verdict::Sat && result.failedRules.empty() && result.inconclusiveRules.empty();
+}
+
+int countLines(const std::string& path, const std::string& text) {
+    std::ifstream log(path);
+    std::string line;
+    int count = 0;
+    while (std::getline(log, line)) {
+        count += line == text;
+    }
+    return count;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cout << "Usage: " << argv[0] << " SOLVER" << std::endl;
+        return 1;
+    }
+    const std::string logPath = "checker_test.log";
+    std::remove(logPath.c_str());
+    setenv("TFL1_SOLVER_LOG", logPath.c_str(), 1);
+
+    CheckerSettings settings;
+    settings.solver = argv[1];
+    TerminationChecker checker(settings);
+
+    expect(proved(checker.check({ { "ab", "ba" } })), "ab -> ba is proved");
+    expect(proved(checker.check("ba -> b\n")), "ba -> b is proved with the letters declared by the first check");
+    expect(checker.check({ { "ua", "a" } }).verdict == Verdict::Unsat, "ua -> a is unsat");
+    expect(proved(checker.check({ { "ab", "ba" } })), "the unsat assertions were popped");
+
+    CheckResult malformed = checker.check("ab\n");
+    expect(malformed.verdict == Verdict::None && malformed.malformed.size() == 1, "a malformed line is reported");
+
+    expect(countLines(logPath, "start") == 1, "one solver process serves all checks");
+    // The last pop is not answered, so the scopes are checked through the depth every push reaches.
+    expect(countLines(logPath, "push 1") == 4, "every check runs in one push/pop scope");
+
+    checker.reset();
+    expect(proved(checker.check({ { "ab", "ba" } })), "ab -> ba is proved after reset");
+    expect(countLines(logPath, "start") == 2, "reset starts a new solver process");
+
+    settings.solver = "tfl1-missing-solver";
+    TerminationChecker missing(settings);
+    CheckResult failed = missing.check({ { "ab", "ba" } });
+    expect(failed.verdict == Verdict::None && !failed.errors.empty(), "a missing solver is reported in errors");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#!/bin/sh
+# Checks a corpus with the coordinator and two local workers over loopback, using a stand-in solver that answers
+# sat at once, with d = 2 for the letter b and 1 everywhere else, but hangs on every system with the letter h. Shards
+# are handed out two systems at a time, the hanging system is retried until it is reported as crashed while the rest
+# of its shard is requeued, a model that does not orient the rules is reported as unverified, and the report keeps
+# the order of the corpus file.
+set -e
+program="$1"
+directory=$(mktemp -d)
+trap 'rm -rf "$directory"' EXIT
+cd "$directory"
+
+cat > z3.exe <<'SOLVER'
+#!/bin/sh
+while read -r line; do
+    case "$line" in
+        *_h\ *) exec sleep 987654 ;;
+        *declare-fun*) set -- $line; names="$names $2" ;;
+        *check-sat*) echo sat ;;
+        *get-model*)
+            echo "("
+            for name in $names; do
+                if [ "$name" = d_b ]; then value=2; else value=1; fi
+                echo "(define-fun $name () Int $value)"
+            done
+            echo ")" ;;
+        *echo*) echo tfl1-done ;;
+    esac
+done
+SOLVER
+chmod +x z3.exe
+
+echo "ab -> ba" > first.txt
+echo "ab" > malformed.txt
+echo "ha -> a" > hanging.txt
+echo "b -> a" > second.txt
+echo "aa -> a" > third.txt
+echo "ba -> b" > fourth.txt
+echo "ba -> ab" > unverified.txt
+printf 'first.txt\nmalformed.txt\nhanging.txt\nsecond.txt\nmissing.txt\nthird.txt\nfourth.txt\nunverified.txt\n' > corpus.txt
+
+cat > expected.txt <<'REPORT'
+first.txt: sat
+malformed.txt: malformed
+hanging.txt: crashed
+second.txt: sat
+missing.txt: unreadable
+third.txt: sat
+fourth.txt: sat
+unverified.txt: unverified
+REPORT
+
+PATH="$directory:$PATH" "$program" --corpus corpus.txt --workers 2 --shard-size 2 --timeout 1 > report.txt 2> log.txt
+if ! diff expected.txt report.txt; then
+    cat log.txt
+    exit 1
+fi
+if ps -eo args= | grep -q "^sleep 987654$"; then
+    echo "A hanging solver was left running."
+    exit 1
+fi